@@ -57,6 +57,9 @@ public:
     }
 
 private:
+    bool isStringAppend() const;
+    ConstantValue evalStringAppend(EvalContext& context, LValue& lvalue) const;
+
     Expression* left_;
     Expression* right_;
     bool nonBlocking;
@@ -10,12 +10,15 @@
 #include <stack>
 #include <vector>
 
+#include <flat_hash_map.hpp>
+
 #include "slang/numeric/ConstantValue.h"
 #include "slang/symbols/Scope.h"
 
 namespace slang {
 
 class BindContext;
+class Expression;
 class LValue;
 class SubroutineSymbol;
 class ValueSymbol;
@@ -98,6 +101,27 @@ public:
     /// this is a top-level expression.
     bool inFunction() const { return stack.size() > 1; }
 
+    /// Records that a loop has started executing. Values of loop-invariant
+    /// expressions inside it are cached until the matching call to endLoop().
+    void beginLoop();
+
+    /// Records that the most recently started loop has finished executing.
+    void endLoop();
+
+    /// Gets the cached value of a loop-invariant expression in the innermost
+    /// executing loop, or nullptr if it hasn't been evaluated yet.
+    const ConstantValue* findLoopInvariant(const Expression& expr);
+
+    /// Caches the value of a loop-invariant expression in the innermost executing loop.
+    void cacheLoopInvariant(const Expression& expr, const ConstantValue& value);
+
+    /// Gets the number of times a loop-invariant expression's cached value was
+    /// used instead of evaluating the expression again.
+    uint64_t getLoopInvariantHits() const { return loopInvariantHits; }
+
+    /// Gets the number of statements executed so far.
+    uint32_t getSteps() const { return steps; }
+
     /// Indicates whether this evaluation context is for a script session
     /// (not used during normal compilation flow).
     bool isScriptEval() const { return (flags & EvalFlags::IsScript) != 0; }
@@ -153,6 +177,13 @@ private:
     const Symbol* disableTarget = nullptr;
     SmallVectorSized<Frame, 4> stack;
     SmallVectorSized<LValue*, 2> lvalStack;
+
+    // Caches for loop-invariant expressions, one per executing loop. Entries past
+    // loopDepth are kept around so that their storage can be reused.
+    std::vector<flat_hash_map<const Expression*, ConstantValue>> loopCaches;
+    size_t loopDepth = 0;
+    uint64_t loopInvariantHits = 0;
+
     Diagnostics diags;
     SourceRange disableRange;
 };
@@ -123,6 +123,12 @@ public:
     /// The kind of expression; indicates the type of derived class.
     ExpressionKind kind;
 
+    /// Set at bind time for expressions inside a loop whose value can't change while
+    /// the loop runs, because they depend only on constants and on local variables
+    /// that the loop doesn't modify. Constant evaluation computes such expressions
+    /// once per execution of the loop.
+    mutable bool isLoopInvariant = false;
+
     /// The type of the expression.
     not_null<const Type*> type;
 
@@ -320,6 +326,11 @@ protected:
     [[nodiscard]] static Expression& selfDetermined(
         Compilation& compilation, const ExpressionSyntax& syntax, const BindContext& context,
         bitmask<BindFlags> extraFlags = BindFlags::None);
+
+    // Replaces a fully constant subexpression with a literal holding its value,
+    // if constant folding is enabled in the compilation options.
+    static void foldConstant(const BindContext& context, Expression*& expr);
+
     struct PropagationVisitor;
 
     template<typename TExpression, typename TVisitor, typename... Args>
@@ -20,6 +20,10 @@ public:
     /// unsized; if false, an explicit size was given.
     bool isDeclaredUnsized;
 
+    /// If this literal was produced by folding a constant subexpression at
+    /// bind time, this points to the original expression tree.
+    const Expression* foldedFrom = nullptr;
+
     IntegerLiteral(BumpAllocator& alloc, const Type& type, const SVInt& value,
                    bool isDeclaredUnsized, SourceRange sourceRange);
 
@@ -45,6 +49,10 @@ private:
 /// Represents a real number literal.
 class RealLiteral : public Expression {
 public:
+    /// If this literal was produced by folding a constant subexpression at
+    /// bind time, this points to the original expression tree.
+    const Expression* foldedFrom = nullptr;
+
     RealLiteral(const Type& type, double value, SourceRange sourceRange) :
         Expression(ExpressionKind::RealLiteral, type, sourceRange), value(value) {}
 
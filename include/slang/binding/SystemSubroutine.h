@@ -31,6 +31,11 @@ public:
     enum class WithClauseMode { None, Iterator, Randomize };
     WithClauseMode withClauseMode = WithClauseMode::None;
 
+    /// Set for system tasks that have an effect when evaluated in a constant
+    /// function or script session, as opposed to being ignored there.
+    /// Such tasks return a non-bad value from eval() when they succeed.
+    bool hasConstantEval = false;
+
     virtual bool allowEmptyArgument(size_t argIndex) const;
     virtual const Expression& bindArgument(size_t argIndex, const BindContext& context,
                                            const ExpressionSyntax& syntax,
@@ -6,6 +6,7 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include <chrono>
 #include <memory>
 
 #include "slang/diagnostics/Diagnostics.h"
@@ -15,6 +16,7 @@
 #include "slang/syntax/SyntaxNode.h"
 #include "slang/util/Bag.h"
 #include "slang/util/BumpAllocator.h"
+#include "slang/util/CancellationToken.h"
 #include "slang/util/SafeIndexedVector.h"
 
 namespace slang {
@@ -23,6 +25,7 @@ class AttributeSymbol;
 class CompilationUnitSymbol;
 class Definition;
 class Expression;
+class GateTable;
 class GenericClassDefSymbol;
 class InstanceBodySymbol;
 class InstanceCache;
@@ -87,6 +90,36 @@ struct CompilationOptions {
     /// source text is hopelessly broken.
     uint32_t typoCorrectionLimit = 32;
 
+    /// The maximum number of bytes the compilation may allocate for symbols, types,
+    /// and other elaborated data before elaboration is stopped, or zero for no limit.
+    uint64_t memoryLimit = 0;
+
+    /// The maximum amount of time, in milliseconds and measured from creation of the
+    /// compilation, that elaboration may run before it is stopped, or zero for no limit.
+    uint32_t timeLimit = 0;
+
+    /// A token that can be used to cancel elaboration from another thread. Once
+    /// cancelled, elaboration and diagnostic collection stop at the next checkpoint
+    /// and return whatever has been built so far; the results are incomplete
+    /// and the compilation should be discarded.
+    CancellationToken cancellation;
+
+    /// If true, constant subexpressions (made up of literals, parameters, and enum
+    /// values) are folded into literals as expressions are bound, so that later
+    /// evaluations don't need to walk the original operator trees.
+    bool foldConstants = false;
+
+    /// If true, simple gate primitive instances are kept in a compact per-scope
+    /// GateTable instead of each getting its own symbol. See GateTable for details.
+    bool compactGates = false;
+
+    /// If true, diagnostic collection only elaborates the design hierarchy: instances,
+    /// parameters, declared types, and port connections. Procedural blocks, subroutine
+    /// bodies, continuous assignments, initializers, and other expressions are left
+    /// unbound (they are still bound if something asks for them) and so any errors
+    /// they contain are not reported.
+    bool hierarchyOnly = false;
+
     /// Specifies which set of min:typ:max expressions should
     /// be used during compilation.
     MinTypMax minTypMax = MinTypMax::Typ;
@@ -326,6 +359,68 @@ public:
         return genericClassAllocator.emplace(std::forward<Args>(args)...);
     }
 
+    /// Checks whether the compilation has exceeded the memory or time budget set in
+    /// its options, or has been cancelled. Memory is tracked as the arena grabs new
+    /// segments, and the time check reads the clock, so this is meant to be called at
+    /// coarse checkpoints (per instance, per generate iteration, per batch of constant
+    /// evaluation steps). Once this has returned true it always returns true.
+    bool checkBudget();
+
+    /// Same as checkBudget(), but the first time a location is available after a
+    /// budget has been exceeded this also issues a fatal diagnostic summarizing
+    /// how far elaboration got. No diagnostic is issued for cancellation.
+    bool checkBudget(const Scope& scope, SourceLocation location);
+
+    /// Returns true if a previous budget check found that the compilation has
+    /// exceeded its memory or time budget, or if it has been cancelled. This is
+    /// cheap enough to be polled for every member.
+    bool isOverBudget() const { return budgetExceeded != BudgetKind::None || isCancelled(); }
+
+    /// Returns true if cancellation has been requested via the token in the options.
+    bool isCancelled() const { return options.cancellation.isCancelled(); }
+
+    /// Statistics about the memory released by a call to compact().
+    struct CompactionStats {
+        /// The approximate number of heap bytes released.
+        uint64_t bytesReclaimed = 0;
+
+        /// The number of side table entries that were released.
+        uint64_t entriesReleased = 0;
+
+        /// The number of syntax trees that were released.
+        uint64_t treesReleased = 0;
+    };
+
+    /// Finishes any remaining lazy elaboration and binding (by collecting all diagnostics)
+    /// and then releases memory that the finished design no longer needs:
+    /// - bookkeeping that is only used while the design is still being elaborated
+    /// - syntax trees that nothing in the design refers to. A tree is released if it is
+    ///   owned only by this compilation, all of its members are module, interface, or
+    ///   program definitions that are never instantiated (not even automatically as a
+    ///   top-level module), and no diagnostic points into it.
+    ///   Note that unused definitions are themselves diagnosed if
+    ///   CompilationOptions::suppressUnused is turned off.
+    ///
+    /// The definitions and placeholder instances for released trees are removed from
+    /// the design. Everything else in the semantic model, the remaining syntax trees,
+    /// and the cached diagnostics all stay valid afterward, so this is intended for
+    /// consumers that hold onto a finished compilation for a long time (AST export,
+    /// connectivity extraction, simulation).
+    CompactionStats compact();
+
+    /// Counters describing how much lazy scope elaboration has been performed.
+    struct ElaborationStats {
+        /// The number of scopes whose deferred members have been elaborated.
+        uint64_t scopesElaborated = 0;
+
+        /// The number of name lookups that were resolved in a scope with pending
+        /// deferred members without having to elaborate them.
+        uint64_t lookupsWithoutElaboration = 0;
+    };
+
+    /// Gets counters describing how much lazy scope elaboration has been performed.
+    const ElaborationStats& getElaborationStats() const { return elabStats; }
+
     int getNextEnumSystemId() { return nextEnumSystemId++; }
     int getNextStructSystemId() { return nextStructSystemId++; }
     int getNextUnionSystemId() { return nextUnionSystemId++; }
@@ -338,6 +433,10 @@ private:
     Scope::DeferredMemberData& getOrAddDeferredData(Scope::DeferredMemberIndex& index);
     void trackImport(Scope::ImportDataIndex& index, const WildcardImportSymbol& import);
     span<const WildcardImportSymbol*> queryImports(Scope::ImportDataIndex index);
+    std::unique_ptr<Scope::MemberIndex>& getMemberIndex(const Scope& scope);
+    void invalidateMemberIndex(const Scope& scope);
+    GateTable& getOrAddGateTable(const Scope& scope);
+    const GateTable* findGateTable(const Scope& scope) const;
 
     bool isFinalizing() const { return finalizing; }
     bool doTypoCorrection() const { return typoCorrections < options.typoCorrectionLimit; }
@@ -348,6 +447,7 @@ private:
     Diagnostic& addDiag(Diagnostic diag);
 
     void parseParamOverrides(flat_hash_map<string_view, const ConstantValue*>& results);
+    void releaseUnreferencedTrees(CompactionStats& stats);
 
     // Stored options object.
     CompilationOptions options;
@@ -393,6 +493,15 @@ private:
     // is stored here and queried during name lookups.
     SafeIndexedVector<Scope::ImportData, Scope::ImportDataIndex> importData;
 
+    // Counters for lazy scope elaboration; updated by Scope.
+    ElaborationStats elabStats;
+
+    // Sideband member indexes for scopes that have been queried by kind or position.
+    flat_hash_map<const Scope*, std::unique_ptr<Scope::MemberIndex>> memberIndexes;
+
+    // Sideband storage for gates in scopes elaborated with the compactGates option.
+    flat_hash_map<const Scope*, std::unique_ptr<GateTable>> gateTables;
+
     // The lookup table for top-level modules. The value is a pair, with the second
     // element being a boolean indicating whether there exists at least one nested
     // module with the given name (requiring a more involved lookup).
@@ -457,6 +566,12 @@ private:
     std::unique_ptr<InstanceCache> instanceCache;
     const SourceManager* sourceManager = nullptr;
     size_t numErrors = 0; // total number of errors inserted into the diagMap
+
+    // Tracking for the resource budgets in the compilation options.
+    enum class BudgetKind { None, Memory, Time, Cancelled };
+    std::chrono::steady_clock::time_point startTime;
+    BudgetKind budgetExceeded = BudgetKind::None;
+    bool budgetReported = false;
     TimeScale defaultTimeScale;
     bool finalized = false;
     bool finalizing = false; // to prevent reentrant calls to getRoot()
@@ -189,14 +189,13 @@ public:
     static std::string reportAll(const SourceManager& sourceManager, span<const Diagnostic> diags);
 
 private:
-    // An entry added by `pragma diagnostic at the given source offset which
-    // sets a diagnostic to the given severity.
+    // A region of a source buffer in which `pragma diagnostic directives have set
+    // a diagnostic to the given severity. The region covers the offsets after
+    // `start`, up to and including `end`.
     struct DiagnosticMapping {
-        size_t offset = 0;
-        optional<DiagnosticSeverity> severity;
-
-        DiagnosticMapping(size_t offset, optional<DiagnosticSeverity> severity) noexcept :
-            offset(offset), severity(severity) {}
+        size_t start;
+        size_t end;
+        DiagnosticSeverity severity;
     };
 
     optional<DiagnosticSeverity> findMappedSeverity(DiagCode code, SourceLocation location) const;
@@ -215,9 +214,10 @@ private:
     // so that we don't do it more than once.
     flat_hash_set<BufferID> reportedIncludeStack;
 
-    // A map from diagnostic -> source file -> list of in-source diagnostic mappings.
-    // These correspond to `pragma diagnostic entries in the source code.
-    flat_hash_map<DiagCode, flat_hash_map<BufferID, std::vector<DiagnosticMapping>>> diagMappings;
+    // A map from diagnostic and source file to the regions of that file in which
+    // `pragma diagnostic entries have changed the diagnostic's severity. The regions
+    // are sorted and don't overlap, so they can be binary searched.
+    flat_hash_map<std::tuple<DiagCode, BufferID>, std::vector<DiagnosticMapping>> diagMappings;
 
     // A list of all registered clients that receive issued diagnostics.
     std::vector<std::shared_ptr<DiagnosticClient>> clients;
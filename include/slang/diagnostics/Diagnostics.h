@@ -7,6 +7,7 @@
 #pragma once
 
 #include <any>
+#include <memory>
 #include <string>
 #include <variant>
 #include <vector>
@@ -71,13 +72,17 @@ std::ostream& operator<<(std::ostream& os, DiagCode code);
 string_view toString(DiagCode code);
 
 /// Wraps up a reported diagnostic along with location in source and any arguments.
+///
+/// Arguments, ranges, and notes live in a shared, reference-counted payload so that
+/// copying a diagnostic (which happens a lot when coalescing diagnostics across
+/// instances and building result lists) is O(1). The payload is cloned on the first
+/// modification of a shared diagnostic.
 class Diagnostic {
 public:
     // Diagnostic-specific arguments that can be used to better report messages.
     using Arg = std::variant<std::string, int64_t, uint64_t, char, ConstantValue, std::any>;
-    std::vector<Arg> args;
-    std::vector<SourceRange> ranges;
-    std::vector<Diagnostic> notes;
+
+    /// If set, the number of instances in which this diagnostic was coalesced.
     optional<size_t> coalesceCount;
 
     /// The specific kind of diagnostic that was issued.
@@ -99,10 +104,27 @@ public:
     /// regardless of what severity mapping rules might be in place.
     bool isError() const;
 
+    /// Gets the arguments that have been added to the diagnostic.
+    span<const Arg> args() const;
+
+    /// Gets the source ranges that should be highlighted by the diagnostic.
+    span<const SourceRange> ranges() const;
+
+    /// Gets the notes that have been attached to the diagnostic.
+    span<const Diagnostic> notes() const;
+
+    /// Returns true if this diagnostic shares its argument storage with another
+    /// instance (i.e. it was copied and neither copy has been modified since).
+    bool sharesStorageWith(const Diagnostic& other) const;
+
     /// Adds a new note to the diagnostic at the given source location.
+    /// The returned reference is valid until the diagnostic is next modified.
     Diagnostic& addNote(DiagCode code, SourceLocation location);
     Diagnostic& addNote(const Diagnostic& diag);
 
+    /// Adds an argument to the diagnostic.
+    Diagnostic& addArg(Arg arg);
+
     /// Adds an argument to the diagnostic.
     Diagnostic& operator<<(const std::string& arg);
     Diagnostic& operator<<(string_view arg);
@@ -114,16 +136,20 @@ public:
 
     template<typename T, typename = std::enable_if_t<std::is_integral_v<T> && std::is_signed_v<T>>>
     Diagnostic& operator<<(T arg) {
-        args.emplace_back((int64_t)arg);
-        return *this;
+        return addArg((int64_t)arg);
     }
 
     template<typename T, typename = void,
              typename = std::enable_if_t<std::is_integral_v<T> && std::is_unsigned_v<T>>>
     Diagnostic& operator<<(T arg) {
-        args.emplace_back((uint64_t)arg);
-        return *this;
+        return addArg((uint64_t)arg);
     }
+
+private:
+    struct Storage;
+    Storage& mutableStorage();
+
+    std::shared_ptr<Storage> storage;
 };
 
 /// A collection of diagnostics.
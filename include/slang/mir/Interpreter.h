@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+//! @file Interpreter.h
+//! @brief Direct execution of MIR procedures
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "slang/mir/Procedure.h"
+
+namespace slang::mir {
+
+/// Executes MIR procedures directly, without generating code for them.
+///
+/// Starting up the JIT has a fixed cost (building an LLVM module, optimizing it,
+/// and emitting machine code) that is only worth paying for procedures that run
+/// many times. Procedures that run once, such as initial blocks, finish faster
+/// when interpreted. The interpreter also counts how many times each procedure
+/// has been run, which a caller can use to decide when to hand a procedure off
+/// to the JIT instead.
+///
+/// Output from display tasks matches what the runtime library produces for
+/// compiled code and is sent to the output handler as each line is flushed.
+class Interpreter {
+public:
+    explicit Interpreter(const MIRBuilder& builder);
+
+    /// Sets the function that receives flushed output. If no handler
+    /// is set output is printed to stdout.
+    void setOutputHandler(std::function<void(std::string_view)> handler) {
+        outputHandler = std::move(handler);
+    }
+
+    /// Runs the given procedure to completion.
+    void run(const Procedure& proc);
+
+    /// Gets the number of times the given procedure has been run.
+    uint32_t getExecutionCount(const Procedure& proc) const;
+
+    /// Gets the current value of a global variable.
+    const ConstantValue& getGlobal(MIRValue val) const;
+
+    /// Saves the current simulation state -- the values of all global variables,
+    /// procedure execution counts, and any output that has not been flushed yet --
+    /// in a compact binary form appended to @a result. Returns false if some value
+    /// is of a kind that can't be saved (associative arrays, currently).
+    bool saveCheckpoint(std::string& result) const;
+
+    /// Restores state saved by saveCheckpoint(). The checkpoint can come from
+    /// another process, as long as it was running the same design. Returns false
+    /// and leaves the current state untouched if the data is malformed, holds a value
+    /// that doesn't fit its variable's type, or was saved from a design with a
+    /// different set of globals or procedures.
+    bool restoreCheckpoint(string_view data);
+
+private:
+    struct Frame {
+        std::vector<ConstantValue> locals;
+        std::vector<ConstantValue> slots;
+    };
+
+    ConstantValue eval(const Frame& frame, MIRValue val) const;
+    ConstantValue& lvalue(Frame& frame, MIRValue val);
+    ConstantValue exec(Frame& frame, const Instr& instr);
+    void sysCall(const Frame& frame, const Instr& instr);
+    uint64_t getDesignHash() const;
+
+    const MIRBuilder& builder;
+    std::vector<ConstantValue> globals;
+    flat_hash_map<const Procedure*, uint32_t> executionCounts;
+    std::string outputBuffer;
+    std::function<void(std::string_view)> outputHandler;
+};
+
+} // namespace slang::mir
@@ -6,6 +6,7 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include <atomic>
 #include <deque>
 #include <map>
 #include <string>
@@ -43,6 +44,61 @@ struct shortreal_t {
     operator float() const { return v; }
 };
 
+/// Represents a SystemVerilog string, for use during constant evaluation.
+///
+/// Copies share a reference-counted buffer, so copying a string is cheap. The buffer
+/// is never modified while it is shared; any modification of a shared string copies
+/// the contents first. Appending to a string that owns its buffer extends it in place,
+/// so building a string up piece by piece in a variable takes linear time.
+class SVString {
+public:
+    SVString() = default;
+    SVString(const std::string& str);
+    SVString(std::string&& str);
+    SVString(const SVString& other) noexcept;
+    SVString(SVString&& other) noexcept;
+    ~SVString();
+    SVString& operator=(const SVString& other) noexcept;
+    SVString& operator=(SVString&& other) noexcept;
+
+    /// Gets the contents of the string for modification, making sure first that
+    /// the buffer isn't shared. The reference is valid until the string is next copied.
+    std::string& mutableStr();
+
+    /// Moves the contents out of the string, leaving it empty.
+    std::string release();
+
+    /// Gets a view of the contents of the string. The view is valid until
+    /// this string is next modified.
+    string_view view() const { return buffer ? string_view(buffer->text) : ""sv; }
+
+    size_t size() const { return buffer ? buffer->text.size() : 0; }
+    bool empty() const { return size() == 0; }
+
+    /// Appends text to the end of the string.
+    void append(string_view text);
+
+    /// Appends another string to the end of this one. If this string is empty
+    /// the other string's buffer is shared instead of copied.
+    void append(const SVString& other);
+
+    bool operator==(const SVString& rhs) const { return view() == rhs.view(); }
+    bool operator<(const SVString& rhs) const { return view() < rhs.view(); }
+
+private:
+    // The buffer is reference counted by hand rather than with a shared_ptr
+    // so that a string fits in a single pointer.
+    struct Buffer {
+        std::string text;
+        std::atomic<uint32_t> refCount = 1;
+    };
+
+    void makeUnique(size_t reserve = 0);
+    void setBuffer(Buffer* newBuffer);
+
+    Buffer* buffer = nullptr;
+};
+
 /// Represents a constant (compile-time evaluated) value, of one of a few possible types.
 /// By default the value is indeterminate, or "bad". Expressions involving bad
 /// values result in bad values, as you might expect.
@@ -52,11 +108,12 @@ public:
     /// This type represents the null value (class handles, etc) in expressions.
     struct NullPlaceholder : std::monostate {};
     using Elements = std::vector<ConstantValue>;
+    using Unpacked = CopyPtr<Elements>;
     using Map = CopyPtr<AssociativeArray>;
     using Queue = CopyPtr<SVQueue>;
 
     using Variant = std::variant<std::monostate, SVInt, real_t, shortreal_t, NullPlaceholder,
-                                 Elements, std::string, Map, Queue>;
+                                 Unpacked, SVString, Map, Queue>;
 
     ConstantValue() = default;
     ConstantValue(nullptr_t) {}
@@ -67,10 +124,12 @@ public:
     ConstantValue(shortreal_t real) : value(real) {}
 
     ConstantValue(NullPlaceholder nul) : value(nul) {}
-    ConstantValue(const Elements& elements) : value(elements) {}
-    ConstantValue(Elements&& elements) : value(std::move(elements)) {}
-    ConstantValue(const std::string& str) : value(str) {}
-    ConstantValue(std::string&& str) : value(std::move(str)) {}
+    ConstantValue(const Elements& elements) : value(Unpacked(elements)) {}
+    ConstantValue(Elements&& elements) : value(Unpacked(std::move(elements))) {}
+    ConstantValue(const std::string& str) : value(SVString(str)) {}
+    ConstantValue(std::string&& str) : value(SVString(std::move(str))) {}
+    ConstantValue(const SVString& str) : value(str) {}
+    ConstantValue(SVString&& str) : value(std::move(str)) {}
 
     ConstantValue(const Map& map) : value(map) {}
     ConstantValue(Map&& map) : value(std::move(map)) {}
@@ -89,8 +148,8 @@ public:
     bool isReal() const { return std::holds_alternative<real_t>(value); }
     bool isShortReal() const { return std::holds_alternative<shortreal_t>(value); }
     bool isNullHandle() const { return std::holds_alternative<NullPlaceholder>(value); }
-    bool isUnpacked() const { return std::holds_alternative<Elements>(value); }
-    bool isString() const { return std::holds_alternative<std::string>(value); }
+    bool isUnpacked() const { return std::holds_alternative<Unpacked>(value); }
+    bool isString() const { return std::holds_alternative<SVString>(value); }
     bool isMap() const { return std::holds_alternative<Map>(value); }
     bool isQueue() const { return std::holds_alternative<Queue>(value); }
 
@@ -104,13 +163,18 @@ public:
     real_t real() const { return std::get<real_t>(value); }
     shortreal_t shortReal() const { return std::get<shortreal_t>(value); }
 
-    span<ConstantValue> elements() { return std::get<Elements>(value); }
-    span<ConstantValue const> elements() const { return std::get<Elements>(value); }
+    span<ConstantValue> elements() { return *std::get<Unpacked>(value); }
+    span<ConstantValue const> elements() const { return *std::get<Unpacked>(value); }
 
-    std::string& str() & { return std::get<std::string>(value); }
-    const std::string& str() const& { return std::get<std::string>(value); }
-    std::string str() && { return std::get<std::string>(std::move(value)); }
-    std::string str() const&& { return std::get<std::string>(std::move(value)); }
+    std::string& str() & { return std::get<SVString>(value).mutableStr(); }
+    std::string str() const& { return std::string(std::get<SVString>(value).view()); }
+    std::string str() && { return std::get<SVString>(value).release(); }
+    std::string str() const&& { return std::string(std::get<SVString>(value).view()); }
+
+    SVString& svString() & { return std::get<SVString>(value); }
+    const SVString& svString() const& { return std::get<SVString>(value); }
+    SVString svString() && { return std::get<SVString>(std::move(value)); }
+    SVString svString() const&& { return std::get<SVString>(value); }
 
     Map& map() & { return std::get<Map>(value); }
     const Map& map() const& { return std::get<Map>(value); }
@@ -160,6 +224,11 @@ private:
     Variant value;
 };
 
+// Constant values are stored in large numbers (e.g. in unpacked arrays), so keep them
+// small: every alternative is at most the size of an SVInt, with aggregates stored
+// out of line, leaving only room for the variant's discriminator.
+static_assert(sizeof(ConstantValue) <= sizeof(SVInt) + sizeof(void*));
+
 /// Represents a SystemVerilog associative array, for use during constant evaluation.
 struct AssociativeArray : public std::map<ConstantValue, ConstantValue> {
     using std::map<ConstantValue, ConstantValue>::map;
@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------
+//! @file MemoryFile.h
+//! @brief Loader for $readmemh / $readmemb memory files
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "slang/numeric/SVInt.h"
+#include "slang/util/Function.h"
+
+namespace slang {
+
+/// Parses memory initialization files in the format accepted by the
+/// $readmemh and $readmemb system tasks (IEEE 1800-2017 21.4).
+///
+/// Files are memory-mapped and parsed in place; runs of plain digits are
+/// converted eight at a time without building intermediate strings, and each
+/// parsed word is handed to a callback along with the address it targets.
+class MemoryFile {
+public:
+    /// Errors that can occur while loading a memory file.
+    enum class Error {
+        None,
+        OpenFailed,
+        InvalidDigit,
+        InvalidAddress,
+        AddressOutOfRange
+    };
+
+    /// Options that control how a memory file is loaded.
+    struct Options {
+        /// The width of each memory word, in bits.
+        bitwidth_t wordWidth = 8;
+
+        /// True to parse hexadecimal digits ($readmemh), false for binary ($readmemb).
+        bool isHex = true;
+
+        /// The lowest valid address in the target memory.
+        uint64_t lowAddress = 0;
+
+        /// The highest valid address in the target memory.
+        uint64_t highAddress = 0;
+
+        /// The optional start address argument passed to the system task.
+        optional<uint64_t> start;
+
+        /// The optional finish address argument passed to the system task.
+        optional<uint64_t> finish;
+    };
+
+    /// The result of loading a memory file.
+    struct Result {
+        /// The error that stopped the load, if any.
+        Error error = Error::None;
+
+        /// The (one-based) line number at which the error occurred.
+        size_t line = 0;
+
+        /// The number of words that were loaded into memory.
+        uint64_t wordsLoaded = 0;
+
+        explicit operator bool() const { return error == Error::None; }
+    };
+
+    /// Invoked for each word in the file with the address to store it at.
+    /// The value is always unsigned and exactly `wordWidth` bits wide.
+    using WordCallback = function_ref<void(uint64_t address, SVInt&& value)>;
+
+    /// Memory-maps the file at the given path and parses it.
+    static Result load(const std::string& path, const Options& options, WordCallback callback);
+
+    /// Parses memory file contents that are already in memory.
+    static Result parse(string_view text, const Options& options, WordCallback callback);
+
+    /// Gets a human-friendly description of the given error.
+    static string_view errorToString(Error error);
+};
+
+} // namespace slang
@@ -32,6 +32,7 @@ struct LexerOptions {
 /// character level.
 class Lexer {
 public:
+    /// Creates a lexer for the given buffer, whose text must end with a null terminator.
     Lexer(SourceBuffer buffer, BumpAllocator& alloc, Diagnostics& diagnostics,
           LexerOptions options = LexerOptions{});
 
@@ -44,6 +45,13 @@ public:
     /// an infinite stream of EndOfFile tokens will be generated
     Token lex(KeywordVersion keywordVersion = LexerFacts::getDefaultKeywordVersion());
 
+    /// Skips ahead over source text that cannot contain a directive, string literal,
+    /// comment, or line continuation. Trailing whitespace before the next interesting
+    /// character is left in place so that the next token's trivia stays intact.
+    /// Returns true if any non-whitespace text was skipped; the tokens for that text
+    /// are simply never produced.
+    bool skipToDirective();
+
     /// Concatenates two tokens together; used for macro pasting.
     static Token concatenateTokens(BumpAllocator& alloc, Token left, Token right);
 
@@ -14,6 +14,7 @@
 #include "slang/syntax/AllSyntax.h"
 #include "slang/syntax/SyntaxFacts.h"
 #include "slang/util/Bag.h"
+#include "slang/util/CancellationToken.h"
 
 namespace slang {
 
@@ -100,11 +101,22 @@ struct ParserOptions {
     /// The maximum depth of nested language constructs (statements, exceptions) before
     /// we give up for fear of stack overflow.
     uint32_t maxRecursionDepth = 1024;
+
+    /// If cancelled, parsing stops at the next member boundary and an
+    /// empty compilation unit is returned, whatever was being parsed.
+    CancellationToken cancellation;
 };
 
 /// Implements a full syntax parser for SystemVerilog.
 class Parser : ParserBase, SyntaxFacts {
 public:
+    /// Thrown out of the parse functions when the cancellation token in the
+    /// parser options fires. parseCompilationUnit catches it and returns an
+    /// empty unit instead.
+    class CancelledException : public std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
     explicit Parser(Preprocessor& preprocessor, const Bag& options = {});
 
     /// Parse a whole compilation unit.
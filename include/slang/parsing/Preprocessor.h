@@ -45,6 +45,12 @@ struct PreprocessorOptions {
 
     /// A set of macro names to undefine at the start of file preprocessing.
     std::vector<std::string> undefines;
+
+    /// If true, each source buffer is scanned for include directives as soon as it's
+    /// pushed, and the files they name are loaded on a background thread so that they're
+    /// usually ready by the time the directive is reached. See
+    /// SourceManager::prefetchIncludes for details.
+    bool prefetchIncludes = false;
 };
 
 /// Preprocessor - Interface between lexer and parser
@@ -126,6 +132,45 @@ public:
     /// Gets all macros that have been defined thus far in the preprocessor.
     std::vector<const DefineDirectiveSyntax*> getDefinedMacros() const;
 
+    /// Copies the state that carries over from one source file to the next within
+    /// a compilation unit (macro definitions, `pragma once headers, and directive
+    /// settings such as `timescale and `default_nettype) from @a other. This allows
+    /// a file to be preprocessed on its own, starting from the state left at the
+    /// end of the files that precede it.
+    void copyStateFrom(const Preprocessor& other);
+
+    /// Sets up this preprocessor to handle one file out of a compilation unit that
+    /// is being split across several preprocessors, such that the tokens produced
+    /// match what a single preprocessor would produce for the whole unit.
+    /// @a precedingTrivia is the trivia of the EndOfFile token produced for the
+    /// previous file, or nullopt if this is the first file; it gets merged onto the
+    /// first token of this file. If @a isLast is false, the EndOfFile token produced
+    /// for this file has its trivia arranged the way it would be if the next file
+    /// followed directly.
+    void setSplitSource(optional<span<const Trivia>> precedingTrivia, bool isLast);
+
+    /// Sets a list of source buffers whose `line and `pragma diagnostic directives
+    /// have already been registered with the source manager (or should not be),
+    /// so that preprocessing the same source more than once doesn't record them twice.
+    void setRegisteredBuffers(span<const SourceBuffer> buffers);
+
+    /// Returns true if there are conditional directive blocks that have been
+    /// opened and not yet closed.
+    bool hasOpenConditionals() const { return !branchStack.empty(); }
+
+    /// Enables or disables directive-only scanning. In this mode next() skips over
+    /// ordinary source text using fast byte searches, only lexing directives, macro
+    /// usages, string literals, comments, and line continuations, so macros, includes,
+    /// and conditional directives all take effect but most other tokens are never
+    /// returned. This is intended for callers that run the preprocessor to the end of
+    /// its input just for its side effects; the EndOfFile token is unaffected.
+    void setDirectivesOnly(bool enabled) { directivesOnly = enabled; }
+
+    /// Gets the buffers that the preprocessor created from text on its own, such as
+    /// the ones holding predefined macros, as opposed to buffers that were pushed
+    /// onto it or that it loaded for include directives.
+    span<const BufferID> getCreatedBuffers() const { return createdBuffers; }
+
 private:
     Preprocessor(const Preprocessor& other);
     Preprocessor& operator=(const Preprocessor& other) = delete;
@@ -168,6 +213,13 @@ private:
     // Reports an error if the given directive occurred inside a design element.
     void checkOutsideDesignElement(Token directive);
 
+    // Merges trivia left over from a previous split source onto the given token.
+    Token mergePrecedingTrivia(Token token);
+
+    // Checks whether `line and `pragma diagnostic directives at the given
+    // location should be registered with the source manager.
+    bool shouldRegisterDirective(SourceLocation location) const;
+
     // Pragma expression parsers
     std::pair<PragmaExpressionSyntax*, bool> parsePragmaExpression();
     std::pair<PragmaExpressionSyntax*, bool> parsePragmaValue();
@@ -348,6 +400,18 @@ private:
     TokenKind unconnectedDrive = TokenKind::Unknown;
     int designElementDepth = 0;
 
+    // State used when a compilation unit is split across several preprocessors;
+    // see setSplitSource() and setRegisteredBuffers().
+    optional<span<const Trivia>> precedingTrivia;
+    bool continuesInNextSource = false;
+    flat_hash_set<BufferID> registeredBuffers;
+
+    // Set when only directives are of interest; see setDirectivesOnly().
+    bool directivesOnly = false;
+
+    // Buffers created from text by the preprocessor itself; see getCreatedBuffers().
+    std::vector<BufferID> createdBuffers;
+
     // Parser for numeric literals in pragma expressions.
     NumberParser numberParser;
     friend class NumberParser;
@@ -0,0 +1,160 @@
+//------------------------------------------------------------------------------
+// FileIO.h
+// Simulation file I/O routines
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace slang::runtime {
+
+/// A file opened by the simulation. Reads and writes go through a large
+/// user-space buffer so that character, line, and token level operations
+/// work directly on buffered memory instead of calling into the C library
+/// for each access.
+class BufferedFile {
+public:
+    /// The size of the buffer allocated for each file.
+    static constexpr size_t BufferSize = 1 << 20;
+
+    /// Wraps the given C file handle. If @a owned is true the handle
+    /// is closed when this object is destroyed.
+    BufferedFile(FILE* file, bool owned);
+    ~BufferedFile();
+
+    BufferedFile(const BufferedFile&) = delete;
+    BufferedFile& operator=(const BufferedFile&) = delete;
+
+    /// Reads a single character, or returns EOF if there is no more data.
+    int getc();
+
+    /// Returns the next character without consuming it, or EOF if there is no more data.
+    int peek();
+
+    /// Pushes a character back so that the next read returns it.
+    bool ungetc(int c);
+
+    /// Ensures that at least @a count bytes are buffered and contiguous,
+    /// unless the end of the file is reached first. Returns the buffered data,
+    /// which remains valid until the next operation on the file.
+    std::string_view window(size_t count);
+
+    /// Consumes @a count bytes of previously buffered data.
+    void consume(size_t count) { pos += count; }
+
+    /// Reads up to @a count bytes into @a dest, returning the number actually read.
+    size_t read(char* dest, size_t count);
+
+    /// Writes the given text to the file.
+    bool write(std::string_view text);
+
+    /// Writes any buffered output to the underlying file.
+    bool flush();
+
+    /// Moves the file position; @a origin is one of SEEK_SET, SEEK_CUR, or SEEK_END.
+    bool seek(int64_t offset, int origin);
+
+    /// Gets the current logical file position.
+    int64_t tell() const;
+
+    /// Returns true if a read has hit the end of the file.
+    bool eof() const { return atEnd && pos == end; }
+
+    /// Gets the error code of the most recent failed operation and clears it.
+    int takeError();
+
+private:
+    bool beginRead();
+    bool beginWrite();
+    bool refill(size_t count);
+
+    // Space left at the start of the buffer on refill so that
+    // characters can always be pushed back with ungetc.
+    static constexpr size_t PushbackSlack = 16;
+
+    FILE* file;
+    bool owned;
+    std::unique_ptr<char[]> buffer;
+    size_t pos = 0;
+    size_t end = 0;
+    int64_t filePos = 0;
+    bool writing = false;
+    bool atEnd = false;
+    int lastError = 0;
+};
+
+/// The table of open files, indexed by the descriptors handed out by $fopen.
+///
+/// Descriptors have the most significant bit set; the first three refer to
+/// stdin, stdout, and stderr. Files opened without a mode are instead given
+/// a multichannel descriptor, in which each bit other than the top one names
+/// a separate file and bit zero refers to stdout.
+class FileTable {
+public:
+    static constexpr uint32_t FdFlag = 1u << 31;
+    static constexpr uint32_t Stdin = FdFlag | 0;
+    static constexpr uint32_t Stdout = FdFlag | 1;
+    static constexpr uint32_t Stderr = FdFlag | 2;
+
+    /// Gets the table used by the running simulation.
+    static FileTable& instance();
+
+    /// Opens the file at @a path. An empty @a mode opens the file for writing
+    /// and returns a multichannel descriptor. Returns zero on failure.
+    uint32_t open(std::string_view path, std::string_view mode);
+
+    /// Closes the given file descriptor or all files named by a multichannel descriptor.
+    void close(uint32_t fd);
+
+    /// Gets the file for a (non-multichannel) descriptor, or nullptr if it's not open.
+    BufferedFile* get(uint32_t fd);
+
+    /// Returns true if the descriptor refers to stdout, which is written
+    /// through the simulation's output handler instead of the table.
+    static bool includesStdout(uint32_t fd);
+
+    /// Writes text to every file named by the descriptor other than stdout.
+    void write(uint32_t fd, std::string_view text);
+
+    /// Flushes the files named by the descriptor, or all files if it is zero.
+    void flush(uint32_t fd);
+
+    /// Gets the error code from the most recent failed open and clears it.
+    int takeOpenError();
+
+private:
+    FileTable();
+
+    static constexpr uint32_t MaxChannels = 30;
+
+    std::vector<std::unique_ptr<BufferedFile>> files;
+    std::unique_ptr<BufferedFile> channels[MaxChannels + 1];
+    int openError = 0;
+};
+
+/// The kinds of destinations that $fscanf / $sscanf can store into.
+enum class ScanArgKind : uint8_t { TwoState, FourState, Real, ShortReal, String };
+
+/// A string produced by the runtime. The data points into runtime-owned
+/// buffers and is only valid until the next I/O call.
+struct ScanString {
+    const char* data;
+    size_t length;
+};
+
+/// A destination for a $fscanf / $sscanf conversion. Integral destinations
+/// point at storage words holding @a width value bits, followed by the
+/// unknown bits for four-state types; string destinations point at a ScanString.
+struct ScanArg {
+    void* data;
+    uint32_t width;
+    ScanArgKind kind;
+};
+
+} // namespace slang::runtime
@@ -0,0 +1,214 @@
+//------------------------------------------------------------------------------
+// WaveDump.h
+// Simulation waveform dumping
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace slang::runtime {
+
+/// Output formats supported by the waveform dumper.
+enum class WaveFormat {
+    /// Standard IEEE 1364 value change dump text.
+    VCD,
+
+    /// A compact binary change log. The file starts with the magic bytes "SLWV",
+    /// a format version byte, and a signal table (varint count, then for each
+    /// signal its varint width, a four-state flag byte, and a varint-length-prefixed
+    /// hierarchical name). It is followed by one record per timestep: a varint
+    /// time delta, a varint change count, and for each change a varint signal
+    /// index plus the little-endian value bytes (and unknown bytes for
+    /// four-state signals).
+    ChangeLog
+};
+
+/// The kind of declaration a dumped signal came from, which determines
+/// the variable type written for it in a VCD header.
+enum class WaveVarKind : uint8_t {
+    /// A net, written as "wire".
+    Wire,
+
+    /// A variable of a packed or simple bit vector type, written as "reg".
+    Reg,
+
+    /// A variable of type integer or int, written as "integer".
+    Integer,
+
+    /// A variable of type time, written as "time".
+    Time
+};
+
+/// Records value changes from a running simulation and writes them out as
+/// waveforms. Changes are buffered per timestep on the simulation thread;
+/// completed timesteps are handed off to a background thread that encodes
+/// them and writes large sequential blocks to the output file, so the cost
+/// paid by the simulation is a memcpy per change.
+///
+/// Only signals selected via selectScope() / selectSignal() (following the
+/// scope and level arguments of $dumpvars) are recorded.
+class WaveDumper {
+public:
+    /// Statistics about the dumping work that has been performed.
+    struct Stats {
+        /// The number of value changes recorded.
+        uint64_t changes = 0;
+
+        /// The number of bytes written to the output file.
+        uint64_t bytesWritten = 0;
+
+        /// Time spent in the dumper on the simulation thread,
+        /// including any time spent waiting for the writer to catch up.
+        std::chrono::nanoseconds dumpTime{ 0 };
+
+        /// Time the background writer spent encoding and writing.
+        std::chrono::nanoseconds writerTime{ 0 };
+
+        /// Wall-clock time since the dumper was created.
+        std::chrono::nanoseconds totalTime{ 0 };
+
+        /// Gets the simulation-thread dumping overhead as a percentage
+        /// of total simulation time.
+        double overheadPercent() const;
+    };
+
+    /// Opens the output file at @a path. @a blockSize controls how much encoded
+    /// data is accumulated before each write to the file.
+    WaveDumper(const std::string& path, WaveFormat format, size_t blockSize = 1 << 20);
+    ~WaveDumper();
+
+    WaveDumper(const WaveDumper&) = delete;
+    WaveDumper& operator=(const WaveDumper&) = delete;
+
+    /// Returns true if the output file was opened successfully.
+    bool isOpen() const { return file != nullptr; }
+
+    /// Sets the time scale string written to the VCD header, e.g. "1ns".
+    void setTimeScale(std::string_view timeScale) { this->timeScale = timeScale; }
+
+    /// Declares a signal that can be dumped. @a scopePath is the dot-separated
+    /// hierarchical path of the scope that contains the signal. Signals must be
+    /// declared before the first call to setTime(). Returns an ID for the signal.
+    uint32_t addSignal(std::string_view scopePath, std::string_view name, uint32_t width,
+                       bool isFourState, WaveVarKind kind);
+
+    /// Selects all signals declared in @a scopePath and in scopes up to @a levels
+    /// levels below it. A level count of zero selects the entire subtree, and an
+    /// empty scope path refers to the root of the design.
+    void selectScope(std::string_view scopePath, uint32_t levels);
+
+    /// Selects a single signal for dumping.
+    void selectSignal(uint32_t id);
+
+    /// Enables or disables recording of value changes ($dumpon / $dumpoff).
+    void setEnabled(bool enabled);
+
+    /// Advances simulation time. Changes recorded since the previous call
+    /// are committed as a single timestep.
+    void setTime(uint64_t time);
+
+    /// Records the current value of a signal. @a data points at the signal's
+    /// storage: the value bits starting at bit zero, and for four-state signals
+    /// the unknown bits packed directly after them starting at bit @a width,
+    /// rounded up to a whole number of words. This is the same layout used by
+    /// readMemory and the file I/O routines.
+    ///
+    /// The changes recorded for the first timestep make up the initial
+    /// $dumpvars section of a VCD file; selected signals that don't get a
+    /// value there are dumped as x (or 0 for two-state signals).
+    void valueChanged(uint32_t id, const uint64_t* data);
+
+    /// Hands all buffered timesteps to the writer and waits for them to
+    /// reach the output file ($dumpflush).
+    void flush();
+
+    /// Flushes all data, stops the writer thread, and closes the file.
+    void close();
+
+    /// Gets statistics about the dumping performed so far.
+    Stats getStats() const;
+
+private:
+    struct Signal {
+        std::string scope;
+        std::string name;
+        std::string code;
+        uint32_t index = 0;
+        uint32_t width;
+        uint32_t words;
+        bool isFourState;
+        WaveVarKind kind;
+        bool selected = false;
+    };
+
+    // A buffer of value changes for one or more timesteps. Each timestep starts
+    // with a TimeMarker word followed by the time; each change is encoded as the
+    // signal ID followed by the signal's raw storage words.
+    struct Block {
+        std::vector<uint64_t> data;
+        bool flush = false;
+    };
+
+    static constexpr uint64_t TimeMarker = UINT64_MAX;
+
+    void start();
+    void submit(bool wait);
+    void writerMain();
+    void encodeHeader(std::string& out) const;
+    void encodeBlock(const Block& block, std::string& out);
+    void encodeVCDValue(const Signal& signal, const uint64_t* data, std::string& out) const;
+    void encodeChangeLogValue(const Signal& signal, const uint64_t* data, std::string& out) const;
+    void finishChangeLogStep(std::string& out);
+    void finishDumpVars(std::string& out);
+    void writeOut(std::string& out, bool force);
+
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<Signal> signals;
+    std::string timeScale = "1ns";
+    WaveFormat format;
+    size_t blockSize;
+    FILE* file = nullptr;
+    bool started = false;
+    bool enabled = true;
+
+    uint64_t currentTime = 0;
+    bool timestepOpen = false;
+    Block pending;
+
+    // Writer thread encoding state.
+    uint64_t lastWrittenTime = 0;
+    bool anyTimeWritten = false;
+    std::string stepChanges;
+    uint64_t stepChangeCount = 0;
+    bool stepOpen = false;
+    bool inDumpVars = false;
+    std::vector<bool> initialDumped;
+
+    Clock::time_point startTime;
+    std::chrono::nanoseconds dumpTime{ 0 };
+    uint64_t changes = 0;
+
+    // State shared with the writer thread.
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Block> queue;
+    bool stopping = false;
+    bool writerIdle = true;
+    uint64_t bytesWritten = 0;
+    std::chrono::nanoseconds writerTime{ 0 };
+    std::thread writer;
+};
+
+} // namespace slang::runtime
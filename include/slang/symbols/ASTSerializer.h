@@ -27,6 +27,11 @@ public:
 
     void setIncludeAddresses(bool set) { includeAddrs = set; }
 
+    /// Sets whether instances found below the symbol being serialized
+    /// have their bodies serialized as well.
+    void setIncludeInstanceBodies(bool set) { includeInstanceBodies = set; }
+    bool includesInstanceBodies() const { return includeInstanceBodies; }
+
     void serialize(const Symbol& symbol);
     void serialize(const Expression& expr);
     void serialize(const Statement& statement);
@@ -88,6 +93,7 @@ private:
     Compilation& compilation;
     JsonWriter& writer;
     bool includeAddrs = true;
+    bool includeInstanceBodies = true;
 };
 
 } // namespace slang
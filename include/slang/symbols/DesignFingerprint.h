@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+//! @file DesignFingerprint.h
+//! @brief Stable structural hashing of an elaborated design
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <vector>
+
+#include "slang/util/Util.h"
+
+namespace slang {
+
+class Compilation;
+class InstanceSymbol;
+class JsonWriter;
+class Scope;
+
+/// Computes structural hashes of an elaborated design, suitable for letting
+/// downstream tools cache results and recompute only what has changed.
+///
+/// Each instance body is hashed from its elaborated form: member symbols, resolved
+/// types, parameter values, expressions and statements, along with the port
+/// connections of any child instances. Source locations, trivia and comments are
+/// not included, so edits that don't change the elaborated design leave every
+/// hash untouched. Body hashes are then combined up the hierarchy so that each
+/// instance also gets a hash covering its entire subtree.
+class DesignFingerprint {
+public:
+    /// The hashes computed for one instance in the design hierarchy.
+    struct Node {
+        /// The instance that was hashed.
+        const InstanceSymbol* instance = nullptr;
+
+        /// A hash of the instance's own body, not counting the
+        /// bodies of any child instances.
+        uint64_t bodyHash = 0;
+
+        /// A hash of the body combined with the subtree hashes of all children.
+        uint64_t subtreeHash = 0;
+
+        /// Nodes for each child instance, in declaration order.
+        std::vector<Node> children;
+    };
+
+    /// Computes hashes for the full design in the given compilation. This forces
+    /// elaboration of the design if it hasn't happened already.
+    explicit DesignFingerprint(Compilation& compilation);
+
+    /// Gets the hash nodes for each top-level instance.
+    const std::vector<Node>& getTopNodes() const { return topNodes; }
+
+    /// Gets a single hash covering the entire design.
+    uint64_t getDesignHash() const { return designHash; }
+
+    /// Writes the hash tree out as JSON. Hashes are written as
+    /// hexadecimal strings since they don't fit in a JSON number.
+    void serialize(JsonWriter& writer) const;
+
+private:
+    Node hashInstance(const InstanceSymbol& instance);
+    void hashChildren(const Scope& scope, std::vector<Node>& results);
+
+    Compilation& compilation;
+    std::vector<Node> topNodes;
+    uint64_t designHash = 0;
+};
+
+} // namespace slang
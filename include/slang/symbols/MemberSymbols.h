@@ -177,6 +177,7 @@ public:
 };
 
 struct GateInstantiationSyntax;
+class GateTable;
 
 class GateSymbol : public Symbol {
 public:
@@ -187,9 +188,11 @@ public:
 
     void serializeTo(ASTSerializer& serializer) const;
 
+    /// Creates symbols for the gates declared by the given syntax. If @a table is
+    /// provided, simple gates are stored there instead of being added to @a results.
     static void fromSyntax(Compilation& compilation, const GateInstantiationSyntax& syntax,
                            LookupLocation location, const Scope& scope,
-                           SmallVector<const Symbol*>& results);
+                           SmallVector<const Symbol*>& results, GateTable* table = nullptr);
 
     static bool isKind(SymbolKind kind) { return kind == SymbolKind::Gate; }
 };
@@ -209,6 +212,79 @@ public:
     static bool isKind(SymbolKind kind) { return kind == SymbolKind::GateArray; }
 };
 
+struct GateInstanceSyntax;
+
+/// Compact storage for the gate primitive instances in a scope, used in place of
+/// individual GateSymbols when CompilationOptions::compactGates is set. Post-synthesis
+/// netlists can contain millions of gates; this keeps each one down to its type, its
+/// syntax node, and the nets it connects to.
+///
+/// Connections that are a plain identifier or a bit-select of one with a literal
+/// index are recorded as net IDs; anything else is left for full binding. Gate
+/// instance arrays and gates with attributes or conflicting names are still
+/// created as normal member symbols.
+///
+/// Gates stored here don't appear in the scope's member list. Lookups by name
+/// still find them, creating the full GateSymbol on demand, and getSymbol() does
+/// the same for any gate by position.
+class GateTable {
+public:
+    /// A connection from a gate terminal to a net.
+    struct Connection {
+        /// The net ID used for connections that aren't a simple net reference.
+        static constexpr uint32_t NoNet = UINT32_MAX;
+
+        /// The bit index used for connections to a whole net.
+        static constexpr int32_t WholeNet = INT32_MIN;
+
+        uint32_t net = NoNet;
+        int32_t bit = WholeNet;
+    };
+
+    explicit GateTable(const Scope& scope) : scope(scope) {}
+
+    /// Tries to add a gate to the table; returns false if the gate has a name
+    /// that collides with an existing member, in which case the caller should
+    /// create a full symbol for it so that the conflict gets reported.
+    bool add(GateType gateType, const GateInstanceSyntax& syntax, SymbolIndex index);
+
+    /// Gets the number of gates in the table.
+    size_t size() const { return gateTypes.size(); }
+
+    GateType getGateType(size_t index) const { return gateTypes[index]; }
+    const GateInstanceSyntax& getSyntax(size_t index) const { return *syntaxes[index]; }
+    string_view getName(size_t index) const;
+
+    /// Gets the connections of the given gate, in terminal order.
+    span<const Connection> getConnections(size_t index) const;
+
+    /// Gets the name of a net referenced by a connection.
+    string_view getNetName(uint32_t net) const { return netNames[net]; }
+
+    /// Gets the number of distinct nets referenced by connections.
+    size_t numNets() const { return netNames.size(); }
+
+    /// Finds the gate with the given name, creating its symbol if necessary.
+    const GateSymbol* find(string_view name) const;
+
+    /// Gets the full symbol for the given gate, creating it if necessary.
+    const GateSymbol& getSymbol(size_t index) const;
+
+private:
+    uint32_t getNetId(string_view name);
+
+    const Scope& scope;
+    std::vector<GateType> gateTypes;
+    std::vector<const GateInstanceSyntax*> syntaxes;
+    std::vector<SymbolIndex> indices;
+    std::vector<uint32_t> connectionOffsets;
+    std::vector<Connection> connections;
+    std::vector<string_view> netNames;
+    flat_hash_map<string_view, uint32_t> netIds;
+    flat_hash_map<string_view, uint32_t> gatesByName;
+    mutable flat_hash_map<uint32_t, const GateSymbol*> symbols;
+};
+
 struct ElabSystemTaskSyntax;
 
 /// Represents an elaboration system task, such as $error or $warning.
@@ -20,6 +20,7 @@ namespace slang {
 class BindContext;
 class Compilation;
 class ForwardingTypedefSymbol;
+class GateTable;
 class NetType;
 class WildcardImportSymbol;
 struct AttributeInstanceSyntax;
@@ -102,9 +103,22 @@ public:
     /// index is of the specified type `T`.
     template<typename T>
     const T& memberAt(uint32_t index) const {
-        return std::next(members().begin(), index)->as<T>();
+        auto array = getMemberArray();
+        ASSERT(index < array.size());
+        return array[index]->as<T>();
     }
 
+    /// Gets all members of the given kind, in declaration order. The first query on a
+    /// scope builds an index of its members (stored on the side in the Compilation, so
+    /// scopes that are never queried don't pay for it) that is reused until another
+    /// member is added to the scope, at which point previously returned spans are no
+    /// longer valid.
+    span<const Symbol* const> membersOfKind(SymbolKind kind) const;
+
+    /// Gets all members of the scope as an array, in declaration order, which allows
+    /// constant time access by position. This shares the index used by membersOfKind().
+    span<const Symbol* const> getMemberArray() const;
+
     /// An iterator for members in the scope.
     class iterator : public iterator_facade<iterator, std::forward_iterator_tag, const Symbol> {
     public:
@@ -208,8 +222,19 @@ public:
 
     const SymbolMap& getUnelaboratedNameMap() const { return *nameMap; }
 
+    /// Looks up a name in the scope's name map, returning the raw entry (which may be
+    /// an import, transparent member, etc) or nullptr if there isn't one. Deferred
+    /// members are only elaborated if the name isn't already present; elaborating them
+    /// can never replace an existing entry, so the result is the same either way.
+    const Symbol* findNameMapEntry(string_view name) const;
+
     span<const WildcardImportSymbol* const> getWildcardImports() const;
 
+    /// Gets the compact storage for gate instances in this scope, if the scope has any.
+    /// Gates stored there are not included in the list of members.
+    /// @see CompilationOptions::compactGates
+    const GateTable* getGateTable() const;
+
 protected:
     Scope(Compilation& compilation_, const Symbol* thisSym_);
 
@@ -281,10 +306,29 @@ private:
     // Sideband collection of wildcard imports stored in the Compilation object.
     using ImportData = std::vector<const WildcardImportSymbol*>;
 
+    // Sideband index of members stored in the Compilation object; built on demand
+    // by membersOfKind() and getMemberArray() and dropped when members are added.
+    struct MemberIndex {
+        // All members in declaration order.
+        std::vector<const Symbol*> members;
+
+        // All members stably sorted by kind, along with the
+        // offset and count of each kind's run in that list.
+        std::vector<const Symbol*> byKind;
+        flat_hash_map<SymbolKind, std::pair<uint32_t, uint32_t>> kindRanges;
+    };
+
+    // Gets the member index for this scope, building it if necessary.
+    const MemberIndex& getMemberIndex() const;
+
     // Inserts the given member symbol into our own list of members, right after
     // the given symbol. If `at` is null, it will insert at the head of the list.
     void insertMember(const Symbol* member, const Symbol* at, bool isElaborating) const;
 
+    // Unlinks the given members from our list of members. Named members are left
+    // in the name map, so this is only suitable for members that can't be looked up.
+    void removeMembers(const flat_hash_set<const Symbol*>& toRemove) const;
+
     // Gets or creates deferred member data in the Compilation object's sideband table.
     DeferredMemberData& getOrAddDeferredData() const;
 
@@ -198,6 +198,7 @@ protected:
 
 private:
     friend class Scope;
+    friend class GateTable;
 
     const Scope* scopeOrNull() const;
 
@@ -29,6 +29,7 @@ public:
                std::shared_ptr<SyntaxTree> parent = nullptr);
 
     SyntaxTree(SyntaxTree&& other) = default;
+    ~SyntaxTree();
 
     /// Creates a syntax tree from a full compilation unit.
     /// @a path is the path to the source file on disk.
@@ -77,6 +78,20 @@ public:
                                                    SourceManager& sourceManager,
                                                    const Bag& options = {});
 
+    /// Same as fromBuffers(), but parses the buffers on multiple threads. A fast serial
+    /// pass first preprocesses each buffer in order to find the macro and directive state
+    /// in effect at each buffer boundary; each buffer is then preprocessed and parsed on
+    /// its own, starting from that state, and the results are stitched together into a
+    /// single compilation unit. The resulting tree and diagnostics are the same as those
+    /// from fromBuffers(). If any buffer can't be parsed on its own (for example,
+    /// because a design element or conditional directive spans a buffer boundary,
+    /// or because of syntax errors) this falls back to parsing everything serially.
+    /// @a numThreads is the number of threads to use, or zero to pick automatically.
+    static std::shared_ptr<SyntaxTree> fromBuffersParallel(span<const SourceBuffer> buffers,
+                                                           SourceManager& sourceManager,
+                                                           const Bag& options = {},
+                                                           uint32_t numThreads = 0);
+
     /// Gets any diagnostics generated while parsing.
     Diagnostics& diagnostics() { return diagnosticsBuffer; }
 
@@ -115,7 +130,8 @@ public:
     /// This is a shared default source manager for cases where the user doesn't
     /// care about managing the lifetime of loaded source. Note that all of
     /// the source loaded by this thing will live in memory for the lifetime of
-    /// the process.
+    /// the process. Long running tools should use their own source manager with
+    /// buffer eviction enabled instead; see SourceManager::setBufferEviction.
     static SourceManager& getDefaultSourceManager();
 
 private:
@@ -124,7 +140,11 @@ private:
 
     static std::shared_ptr<SyntaxTree> create(SourceManager& sourceManager,
                                               span<const SourceBuffer> source, const Bag& options,
-                                              bool guess);
+                                              bool guess, bool directivesRegistered = false);
+
+    // Keeps the given buffers alive for as long as this tree is, if the
+    // source manager has buffer eviction enabled.
+    void retainBuffers(span<const SourceBuffer> sources, span<const BufferID> created);
 
     SyntaxNode* rootNode;
     SourceManager& sourceMan;
@@ -134,6 +154,7 @@ private:
     Bag options_;
     std::shared_ptr<SyntaxTree> parentTree;
     Token eof;
+    std::vector<BufferID> retainedBuffers;
 };
 
 } // namespace slang
@@ -163,7 +163,9 @@ private:
 /// code along with an identifier for the buffer which potentially
 /// encodes its include stack.
 struct SourceBuffer {
-    /// A view into the text comprising the buffer.
+    /// A view into the text comprising the buffer. The last character is always
+    /// a null terminator, which the lexer uses as a sentinel to find the end
+    /// of the text without needing bounds checks.
     string_view data;
 
     /// The ID assigned to the buffer.
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <deque>
 #include <filesystem>
 #include <flat_hash_map.hpp>
@@ -14,6 +15,7 @@
 #include <mutex>
 #include <set>
 #include <shared_mutex>
+#include <thread>
 #include <variant>
 #include <unordered_map>
 #include <vector>
@@ -37,6 +39,7 @@ enum class DiagnosticSeverity;
 class SourceManager {
 public:
     SourceManager();
+    ~SourceManager();
     SourceManager(const SourceManager&) = delete;
     SourceManager& operator=(const SourceManager&) = delete;
 
@@ -128,16 +131,85 @@ public:
                             SourceLocation includedFrom = SourceLocation());
 
     /// Instead of loading source from a file, move it from text already in memory.
-    /// Pretend it came from a file located at @a path.
+    /// Pretend it came from a file located at @a path. A null terminator is appended
+    /// to @a buffer if it doesn't already end with one.
     SourceBuffer assignBuffer(string_view path, std::vector<char>&& buffer,
                               SourceLocation includedFrom = SourceLocation());
 
+    /// Instead of loading source from a file, use text already in memory that is owned
+    /// by the caller, without copying it. Pretend it came from a file located at @a path.
+    ///
+    /// @a text must end with a null terminator, which the lexer relies on as a sentinel
+    /// to find the end of the buffer; std::invalid_argument is thrown if it doesn't.
+    /// The memory must stay valid and unchanged for as long as the buffer is in use.
+    /// The source manager holds on to @a owner for exactly that long, so it can be
+    /// a shared_ptr to the storage itself or one with a custom deleter that gets
+    /// called once the buffer is no longer needed.
+    SourceBuffer assignExternalText(string_view path, string_view text,
+                                    std::shared_ptr<const void> owner,
+                                    SourceLocation includedFrom = SourceLocation());
+
     /// Read in a source file from disk.
     SourceBuffer readSource(string_view path);
 
     /// Read in a header file from disk.
     SourceBuffer readHeader(string_view path, SourceLocation includedFrom, bool isSystemPath);
 
+    /// Scans @a buffer for include directives naming a file with a quoted or angle
+    /// bracketed path and starts loading those files into the cache on a background
+    /// thread, resolving them the same way readHeader() would. Files loaded this way
+    /// are scanned in turn, so whole include trees get fetched ahead of time.
+    ///
+    /// The scan is a quick search through the raw bytes that doesn't know about
+    /// comments, conditional directives, or macros, so it can miss includes or fetch
+    /// files that end up not being used; either way, readHeader() will still find
+    /// the right file. This is only worthwhile when reading files is slow, such as
+    /// on network filesystems.
+    ///
+    /// Prefetched files aren't reported by getLoadedFiles() until something actually
+    /// reads them. With buffer eviction enabled, the ones still unused are dropped
+    /// when the root of @a buffer is released.
+    void prefetchIncludes(SourceBuffer buffer);
+
+    /// Blocks until all includes queued by prefetchIncludes() have been loaded.
+    void waitForPrefetch();
+
+    /// Gets the full paths of all files that have been successfully read from disk,
+    /// either as sources or as headers, sorted by path. Buffers created from text
+    /// in memory are not included, and neither are files that were prefetched but
+    /// never read.
+    std::vector<std::string> getLoadedFiles() const;
+
+    /// Enables or disables releasing buffers once nothing references them anymore.
+    /// By default every buffer lives as long as the source manager, which is fine for
+    /// a one-shot compile but not for a long running process that parses many files
+    /// over time.
+    ///
+    /// When enabled, every buffer created is owned by a root buffer: a file included
+    /// from another buffer or a macro expansion belongs to the root of the buffer it
+    /// came from, and anything else is its own root. Root buffers are kept alive by
+    /// calls to retainBuffers() and freed, along with everything they own, when the
+    /// last retain is undone by releaseBuffers(). SyntaxTrees do this for the buffers
+    /// they were parsed from, so the buffers live exactly as long as the trees (and any
+    /// Compilations holding them) do. File contents are shared between all buffers
+    /// that loaded the same file and freed once the last of them goes away.
+    ///
+    /// Buffer IDs and locations referring to freed buffers must no longer be used;
+    /// their IDs get reused for new buffers. This should be set before creating
+    /// any buffers; buffers created while it's disabled are never freed.
+    void setBufferEviction(bool enabled);
+
+    /// Returns true if buffer eviction is enabled. @see setBufferEviction
+    bool isBufferEvictionEnabled() const { return evictionEnabled; }
+
+    /// Adds a reference to each of the given root buffers, keeping them and all of
+    /// the buffers they own alive. Has no effect if buffer eviction is not enabled.
+    void retainBuffers(span<const BufferID> buffers);
+
+    /// Removes a reference previously added by retainBuffers(). Root buffers left
+    /// without references are freed along with all of the buffers they own.
+    void releaseBuffers(span<const BufferID> buffers);
+
     /// Adds a line directive at the given location.
     void addLineDirective(SourceLocation location, size_t lineNum, string_view name, uint8_t level);
 
@@ -187,13 +259,24 @@ private:
 
     // Stores actual file contents and metadata; only one per loaded file
     struct FileData {
-        const std::string name;          // name of the file
-        const std::vector<char> mem;     // file contents
-        std::vector<size_t> lineOffsets; // cache of compute line offsets
-        const fs::path* const directory; // directory in which the file exists
+        const std::string name;                  // name of the file
+        const std::vector<char> mem;             // file contents, unless owned externally
+        const std::shared_ptr<const void> owner; // keeps externally owned contents alive
+        const string_view text;                  // file contents, including null terminator
+        std::vector<size_t> lineOffsets;         // cache of compute line offsets
+        const fs::path* const directory;         // directory in which the file exists
+        const std::string* cacheKey = nullptr;   // key in lookupCache, if loaded from disk
+        uint32_t refCount = 0;                   // number of live buffers using the data
 
         FileData(const fs::path* directory, std::string name, std::vector<char>&& data) :
-            name(std::move(name)), mem(std::move(data)), directory(directory) {}
+            name(std::move(name)), mem(std::move(data)), text(mem.data(), mem.size()),
+            directory(directory) {}
+
+        FileData(std::string name, string_view text, std::shared_ptr<const void> owner) :
+            name(std::move(name)), owner(std::move(owner)), text(text), directory(nullptr) {}
+
+        FileData(const FileData&) = delete;
+        FileData& operator=(const FileData&) = delete;
     };
 
     // Stores a pointer to file data along with information about where we included it.
@@ -245,7 +328,7 @@ private:
     std::unordered_map<std::string, std::unique_ptr<FileData>> lookupCache;
 
     // extra file data that came from programmatic buffers instead of a real file on disk
-    std::deque<FileData> userFileBuffers;
+    flat_hash_map<const FileData*, std::unique_ptr<FileData>> userFileBuffers;
 
     // map to lookup user programmatic buffers
     flat_hash_map<std::string, FileData*> userFileLookup;
@@ -262,20 +345,64 @@ private:
 
     std::atomic<uint32_t> unnamedBufferCount = 0;
 
+    // state for buffer eviction; see setBufferEviction()
+    bool evictionEnabled = false;
+
+    // the root buffer that owns each entry, or zero if the entry is never freed
+    std::vector<uint32_t> entryRoots;
+
+    // the entries owned by each root buffer, not counting the root itself
+    flat_hash_map<uint32_t, std::vector<uint32_t>> ownedEntries;
+
+    // the number of references to each retained root buffer
+    flat_hash_map<uint32_t, uint32_t> rootRefCounts;
+
+    // entries that have been freed and can be reused
+    std::vector<uint32_t> freeEntries;
+
+    // state for include prefetching; see prefetchIncludes()
+    struct PrefetchRequest {
+        std::string path;
+        const fs::path* directory;
+        uint32_t owner; // root buffer that led to the request, if tracked
+        bool isSystemPath;
+    };
+
+    // cache keys of files prefetched on behalf of each root buffer
+    flat_hash_map<uint32_t, std::vector<std::string>> prefetchedFiles;
+
+    std::mutex prefetchMutex;
+    std::condition_variable prefetchCv;
+    std::deque<PrefetchRequest> prefetchQueue;
+    std::thread prefetchThread;
+    bool prefetchBusy = false;
+    bool prefetchStopping = false;
+
     FileInfo* getFileInfo(BufferID buffer);
     const FileInfo* getFileInfo(BufferID buffer) const;
     SourceBuffer createBufferEntry(FileData* fd, SourceLocation includedFrom,
                                    std::unique_lock<std::shared_mutex>& lock);
 
+    uint32_t addEntry(std::variant<FileInfo, ExpansionInfo>&& entry, SourceLocation owner);
+    void freeEntry(uint32_t id);
+
     SourceBuffer openCached(const fs::path& fullPath, SourceLocation includedFrom);
     SourceBuffer cacheBuffer(const fs::path& path, SourceLocation includedFrom,
                              std::vector<char>&& buffer);
+    FileData* addCachedData(const fs::path& path, std::string&& name, std::vector<char>&& buffer,
+                            std::unique_lock<std::shared_mutex>& lock);
+
+    void queueIncludes(string_view text, const fs::path* directory, uint32_t owner);
+    void prefetchMain();
+    void prefetchHeader(const PrefetchRequest& request);
+    bool prefetchFile(const fs::path& fullPath, uint32_t owner);
 
     // Get raw line number of a file location, ignoring any line directives
     size_t getRawLineNumber(SourceLocation location) const;
 
-    static void computeLineOffsets(const std::vector<char>& buffer,
-                                   std::vector<size_t>& offsets) noexcept;
+    SourceBuffer addUserBuffer(std::unique_ptr<FileData> fd, SourceLocation includedFrom);
+
+    static void computeLineOffsets(string_view buffer, std::vector<size_t>& offsets) noexcept;
 
     static bool readFile(const fs::path& path, std::vector<char>& buffer);
 };
@@ -50,6 +50,19 @@ public:
     /// The other allocator will be in a moved-from state after the call.
     void steal(BumpAllocator&& other);
 
+    /// Gets the total number of bytes of segment memory that the allocator has
+    /// requested from the system so far.
+    size_t getBytesAllocated() const { return bytesAllocated; }
+
+    /// Sets a soft limit on the number of bytes the allocator should request
+    /// from the system. The limit is only checked when a new segment is needed,
+    /// and exceeding it doesn't cause allocations to fail; callers are expected
+    /// to poll isOverByteLimit() at convenient points and wind down.
+    void setByteLimit(size_t limit) { byteLimit = limit; }
+
+    /// Returns true if the allocator has grown beyond its configured byte limit.
+    bool isOverByteLimit() const { return bytesAllocated > byteLimit; }
+
 protected:
     // Allocations are tracked as a linked list of segments.
     struct Segment {
@@ -59,6 +72,8 @@ protected:
 
     Segment* head;
     byte* endPtr;
+    size_t bytesAllocated = 0;
+    size_t byteLimit = SIZE_MAX;
 
     enum { INITIAL_SIZE = 512, SEGMENT_SIZE = 4096 };
 
@@ -70,7 +85,7 @@ protected:
                                        ~(alignment - 1));
     }
 
-    static Segment* allocSegment(Segment* prev, size_t size);
+    Segment* allocSegment(Segment* prev, size_t size);
 };
 
 /// A strongly-typed version of the BumpAllocator, which has the additional
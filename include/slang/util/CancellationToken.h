@@ -0,0 +1,48 @@
+//------------------------------------------------------------------------------
+//! @file CancellationToken.h
+//! @brief Cooperative cancellation of long-running work
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace slang {
+
+/// A handle that lets one thread ask work running on another thread to stop early.
+///
+/// Copies of a token share the same state, so a token can be placed into parser and
+/// compilation options and later cancelled from anywhere else that holds a copy.
+/// The work being cancelled polls isCancelled() at cheap checkpoints and winds
+/// down on its own; nothing is interrupted forcibly.
+///
+/// A default constructed token can never be cancelled. Use create() to get one
+/// that can.
+class CancellationToken {
+public:
+    CancellationToken() = default;
+
+    /// Creates a new token that is not yet cancelled.
+    static CancellationToken create() {
+        CancellationToken result;
+        result.state = std::make_shared<std::atomic<bool>>(false);
+        return result;
+    }
+
+    /// Requests cancellation of all work using this token (or a copy of it).
+    /// Has no effect on a default constructed token.
+    void cancel() const {
+        if (state)
+            state->store(true, std::memory_order_relaxed);
+    }
+
+    /// Returns true if cancellation has been requested.
+    bool isCancelled() const { return state && state->load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> state;
+};
+
+} // namespace slang
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <fmt/color.h>
+#include <vector>
 
 #include "slang/util/String.h"
 
@@ -81,4 +82,35 @@ private:
 #endif
 };
 
+/// A read-only view of the contents of a file. Where the platform supports it
+/// the file is memory-mapped instead of being copied into a buffer, which makes
+/// single-pass scans over very large files cheap.
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    /// Opens and maps the file at the given path. Returns false if the
+    /// file could not be opened.
+    bool open(const std::string& path);
+
+    /// Unmaps the file, if one is open.
+    void close();
+
+    /// Gets the contents of the file.
+    string_view text() const { return string_view(data, size); }
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+    std::vector<char> fallback;
+
+#if defined(_MSC_VER)
+    void* mappingHandle = nullptr;
+#endif
+};
+
 } // namespace slang
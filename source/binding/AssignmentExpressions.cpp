@@ -36,8 +36,14 @@ bool recurseCheckEnum(const Expression& expr) {
         case ExpressionKind::HierarchicalValue:
         case ExpressionKind::MemberAccess:
             return true;
-        case ExpressionKind::IntegerLiteral:
-            return expr.as<IntegerLiteral>().isDeclaredUnsized;
+        case ExpressionKind::IntegerLiteral: {
+            // A folded constant is judged by the expression it was folded from,
+            // so that folding doesn't change which diagnostics are issued.
+            auto& literal = expr.as<IntegerLiteral>();
+            if (literal.foldedFrom)
+                return recurseCheckEnum(*literal.foldedFrom);
+            return literal.isDeclaredUnsized;
+        }
         case ExpressionKind::UnaryOp:
             return recurseCheckEnum(expr.as<UnaryExpression>().operand());
         case ExpressionKind::BinaryOp: {
@@ -475,6 +481,9 @@ ConstantValue AssignmentExpression::evalImpl(EvalContext& context) const {
     if (!lvalue)
         return nullptr;
 
+    if (!isCompound() && isStringAppend())
+        return evalStringAppend(context, lvalue);
+
     if (isCompound())
         context.pushLValue(lvalue);
 
@@ -490,6 +499,56 @@ ConstantValue AssignmentExpression::evalImpl(EvalContext& context) const {
     return rvalue;
 }
 
+bool AssignmentExpression::isStringAppend() const {
+    if (left().kind != ExpressionKind::NamedValue || right().kind != ExpressionKind::Concatenation ||
+        !right().type->isString()) {
+        return false;
+    }
+
+    auto operands = right().as<ConcatenationExpression>().operands();
+    if (operands.empty() || operands[0]->kind != ExpressionKind::NamedValue)
+        return false;
+
+    return &operands[0]->as<NamedValueExpression>().symbol ==
+           &left().as<NamedValueExpression>().symbol;
+}
+
+ConstantValue AssignmentExpression::evalStringAppend(EvalContext& context, LValue& lvalue) const {
+    // Handles "s = {s, ...}" by appending to the stored string directly. Going through
+    // the general path would copy the whole string each time, since the concatenation
+    // result and the variable share a buffer until the store replaces it.
+    auto operands = right().as<ConcatenationExpression>().operands();
+    ConstantValue first = operands[0]->eval(context);
+    if (!first)
+        return nullptr;
+
+    SVString suffix;
+    for (auto operand : operands.subspan(1)) {
+        ConstantValue v = operand->eval(context);
+        if (!v)
+            return nullptr;
+
+        if (!operand->type->isVoid())
+            suffix.append(v.svString());
+    }
+
+    // Evaluating the suffix may have assigned to the variable; only append in place
+    // if it still holds the buffer we read at the start.
+    string_view firstText = first.svString().view();
+    ConstantValue* target = lvalue.resolve();
+    if (target && target->isString() && target->svString().view().data() == firstText.data() &&
+        target->svString().size() == firstText.size()) {
+        first = nullptr;
+        target->svString().append(suffix);
+        return *target;
+    }
+
+    SVString result = std::move(first).svString();
+    result.append(suffix);
+    lvalue.store(result);
+    return result;
+}
+
 bool AssignmentExpression::verifyConstantImpl(EvalContext& context) const {
     if (!context.isScriptEval() && timingControl) {
         context.addDiag(diag::ConstEvalTimedStmtNotConst, sourceRange);
@@ -253,7 +253,7 @@ static void packBitstream(ConstantValue& value, SmallVector<ConstantValue*>& pac
         packed.append(&value);
     }
     else if (value.isString()) {
-        if (!value.str().empty())
+        if (!value.svString().empty())
             packed.append(&value);
     }
     else if (value.isUnpacked()) {
@@ -78,12 +78,51 @@ LValue* EvalContext::getTopLValue() const {
     return lvalStack.back();
 }
 
+void EvalContext::beginLoop() {
+    if (loopDepth == loopCaches.size())
+        loopCaches.emplace_back();
+    else
+        loopCaches[loopDepth].clear();
+    loopDepth++;
+}
+
+void EvalContext::endLoop() {
+    ASSERT(loopDepth);
+    loopDepth--;
+}
+
+const ConstantValue* EvalContext::findLoopInvariant(const Expression& expr) {
+    if (!loopDepth)
+        return nullptr;
+
+    auto& cache = loopCaches[loopDepth - 1];
+    auto it = cache.find(&expr);
+    if (it == cache.end())
+        return nullptr;
+
+    loopInvariantHits++;
+    return &it->second;
+}
+
+void EvalContext::cacheLoopInvariant(const Expression& expr, const ConstantValue& value) {
+    if (loopDepth)
+        loopCaches[loopDepth - 1].emplace(&expr, value);
+}
+
 bool EvalContext::step(SourceLocation loc) {
-    if (++steps < compilation.getOptions().maxConstexprSteps)
-        return true;
+    if (++steps >= compilation.getOptions().maxConstexprSteps) {
+        addDiag(diag::ConstEvalExceededMaxSteps, loc);
+        return false;
+    }
 
-    addDiag(diag::ConstEvalExceededMaxSteps, loc);
-    return false;
+    // Checking the compilation's resource budget reads the clock,
+    // so only do it once per batch of steps.
+    if ((steps & 0xfff) == 0 && compilation.checkBudget()) {
+        addDiag(diag::ConstEvalHalted, loc);
+        return false;
+    }
+
+    return true;
 }
 
 std::string EvalContext::dumpStack() const {
@@ -29,18 +29,76 @@ struct EvalVisitor {
         if (expr.constant)
             return *expr.constant;
 
+        if (expr.isLoopInvariant) {
+            if (auto cached = context.findLoopInvariant(expr))
+                return *cached;
+        }
+
         ConstantValue cv = expr.evalImpl(context);
         if (cv && context.cacheResults()) {
             expr.constant = context.compilation.allocConstant(std::move(cv));
             return *expr.constant;
         }
 
+        if (cv && expr.isLoopInvariant)
+            context.cacheLoopInvariant(expr, cv);
+
         return cv;
     }
 
     ConstantValue visitInvalid(const Expression&, EvalContext&) { return nullptr; }
 };
 
+// Returns true if the expression is made up solely of literals, references to
+// parameters and enum values, and operators applied to them, which means it
+// has the same value everywhere it could be evaluated.
+bool isFoldable(const Expression& expr) {
+    switch (expr.kind) {
+        case ExpressionKind::IntegerLiteral:
+        case ExpressionKind::RealLiteral:
+        case ExpressionKind::UnbasedUnsizedIntegerLiteral:
+            return true;
+        case ExpressionKind::NamedValue: {
+            auto& symbol = expr.as<NamedValueExpression>().symbol;
+            return symbol.kind == SymbolKind::Parameter || symbol.kind == SymbolKind::EnumValue;
+        }
+        case ExpressionKind::UnaryOp: {
+            auto& op = expr.as<UnaryExpression>();
+            switch (op.op) {
+                case UnaryOperator::Preincrement:
+                case UnaryOperator::Predecrement:
+                case UnaryOperator::Postincrement:
+                case UnaryOperator::Postdecrement:
+                    return false;
+                default:
+                    return isFoldable(op.operand());
+            }
+        }
+        case ExpressionKind::BinaryOp: {
+            auto& op = expr.as<BinaryExpression>();
+            return isFoldable(op.left()) && isFoldable(op.right());
+        }
+        case ExpressionKind::ConditionalOp: {
+            auto& op = expr.as<ConditionalExpression>();
+            return isFoldable(op.pred()) && isFoldable(op.left()) && isFoldable(op.right());
+        }
+        case ExpressionKind::Conversion:
+            return isFoldable(expr.as<ConversionExpression>().operand());
+        case ExpressionKind::Concatenation:
+            for (auto op : expr.as<ConcatenationExpression>().operands()) {
+                if (!isFoldable(*op))
+                    return false;
+            }
+            return true;
+        case ExpressionKind::Replication: {
+            auto& op = expr.as<ReplicationExpression>();
+            return isFoldable(op.count()) && isFoldable(op.concat());
+        }
+        default:
+            return false;
+    }
+}
+
 class LValueVisitor {
     template<typename T, typename Arg>
     using evalLValue_t = decltype(std::declval<T>().evalLValueImpl(std::declval<Arg>()));
@@ -923,12 +981,65 @@ void Expression::contextDetermined(const BindContext& context, Expression*& expr
                                    const Type& newType, SourceLocation assignmentLoc) {
     PropagationVisitor visitor(context, newType, assignmentLoc);
     expr = &expr->visit(visitor);
+    foldConstant(context, expr);
 }
 
 void Expression::selfDetermined(const BindContext& context, Expression*& expr) {
     ASSERT(expr->type);
     PropagationVisitor visitor(context, *expr->type, {});
     expr = &expr->visit(visitor);
+    foldConstant(context, expr);
+}
+
+void Expression::foldConstant(const BindContext& context, Expression*& expr) {
+    Compilation& comp = context.getCompilation();
+    if (!comp.getOptions().foldConstants || expr->bad())
+        return;
+
+    // Only operator trees are worth folding; leaves are already as cheap
+    // to evaluate as a literal would be.
+    switch (expr->kind) {
+        case ExpressionKind::UnaryOp:
+        case ExpressionKind::BinaryOp:
+        case ExpressionKind::ConditionalOp:
+        case ExpressionKind::Conversion:
+        case ExpressionKind::Concatenation:
+        case ExpressionKind::Replication:
+            break;
+        default:
+            return;
+    }
+
+    if (!isFoldable(*expr) || expr->isImplicitString())
+        return;
+
+    // Evaluate in a private context; if anything at all gets reported, keep the
+    // original tree so that diagnostics are issued exactly as they would be otherwise.
+    EvalContext evalContext(comp);
+    ConstantValue value = expr->eval(evalContext);
+    if (!value || !evalContext.getDiagnostics().empty())
+        return;
+
+    Expression* result;
+    if (value.isInteger() && expr->type->isIntegral() &&
+        value.integer().getBitWidth() == expr->type->getBitWidth()) {
+        auto literal = comp.emplace<IntegerLiteral>(comp, *expr->type, value.integer(), false,
+                                                    expr->sourceRange);
+        literal->foldedFrom = expr;
+        result = literal;
+    }
+    else if (value.isReal() && expr->type->isFloating() && expr->type->getBitWidth() == 64) {
+        auto literal = comp.emplace<RealLiteral>(*expr->type, value.real(), expr->sourceRange);
+        literal->foldedFrom = expr;
+        result = literal;
+    }
+    else {
+        return;
+    }
+
+    result->syntax = expr->syntax;
+    result->constant = comp.allocConstant(std::move(value));
+    expr = result;
 }
 
 Expression& Expression::selfDetermined(Compilation& compilation, const ExpressionSyntax& syntax,
@@ -52,7 +52,8 @@ ConstantValue LValue::load() const {
                 }
                 else if constexpr (std::is_same_v<T, ElementIndex>) {
                     if (result.isString()) {
-                        result = SVInt(8, (uint64_t)result.str()[size_t(arg.index)], false);
+                        result = SVInt(8, (uint64_t)result.svString().view()[size_t(arg.index)],
+                                       false);
                     }
                     else if (arg.index < 0 || size_t(arg.index) >= result.size()) {
                         result = arg.defaultValue;
@@ -69,6 +69,9 @@ ConstantValue IntegerLiteral::evalImpl(EvalContext&) const {
 }
 
 optional<bitwidth_t> IntegerLiteral::getEffectiveWidthImpl() const {
+    if (foldedFrom)
+        return foldedFrom->getEffectiveWidth();
+
     auto&& val = getValue();
     if (val.hasUnknown())
         return val.getBitWidth();
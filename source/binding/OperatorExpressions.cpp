@@ -1387,7 +1387,9 @@ ConstantValue ConcatenationExpression::evalImpl(EvalContext& context) const {
     }
 
     if (type->isString()) {
-        std::string result;
+        // The result shares storage with the first operand where possible,
+        // so that appending to a string in a loop doesn't copy it each time.
+        SVString result;
         for (auto operand : operands()) {
             ConstantValue v = operand->eval(context);
             if (!v)
@@ -1397,7 +1399,7 @@ ConstantValue ConcatenationExpression::evalImpl(EvalContext& context) const {
             if (operand->type->isVoid())
                 continue;
 
-            result.append(v.str());
+            result.append(v.svString());
         }
 
         return result;
@@ -1543,9 +1545,9 @@ ConstantValue ReplicationExpression::evalImpl(EvalContext& context) const {
             return nullptr;
         }
 
-        std::string result;
+        SVString result;
         for (int32_t i = 0; i < *optCount; i++)
-            result.append(v.str());
+            result.append(v.svString());
 
         return result;
     }
@@ -2107,8 +2109,8 @@ ConstantValue Expression::evalBinaryOperator(BinaryOperator op, const ConstantVa
         return SVInt(true);
     }
     else if (cvl.isString()) {
-        auto& l = cvl.str();
-        auto& r = cvr.str();
+        auto l = cvl.svString().view();
+        auto r = cvr.svString().view();
 
         switch (op) {
             OP(GreaterThanEqual, SVInt(l >= r));
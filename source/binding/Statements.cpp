@@ -7,6 +7,7 @@
 #include "slang/binding/Statements.h"
 
 #include "slang/binding/Expression.h"
+#include "slang/binding/SystemSubroutine.h"
 #include "slang/binding/TimingControl.h"
 #include "slang/compilation/Compilation.h"
 #include "slang/diagnostics/ConstEvalDiags.h"
@@ -50,6 +51,216 @@ struct VerifyVisitor {
     bool visitInvalid(const Statement&, EvalContext&) { return false; }
 };
 
+// Enables caching of loop-invariant expression values for the duration of a loop.
+struct LoopCacheGuard {
+    EvalContext& context;
+
+    explicit LoopCacheGuard(EvalContext& context) : context(context) { context.beginLoop(); }
+    ~LoopCacheGuard() { context.endLoop(); }
+};
+
+// Collects the symbols that might be modified by running a loop.
+struct LoopModifiedVisitor : public ASTVisitor<LoopModifiedVisitor, true, true> {
+    flat_hash_set<const Symbol*> modified;
+
+    void addTargets(const Expression& expr) {
+        expr.visit(makeVisitor([this](const NamedValueExpression& e) { modified.emplace(&e.symbol); },
+                               [this](const HierarchicalValueExpression& e) {
+                                   modified.emplace(&e.symbol);
+                               }));
+    }
+
+    void handle(const AssignmentExpression& expr) {
+        addTargets(expr.left());
+        visitDefault(expr);
+    }
+
+    void handle(const UnaryExpression& expr) {
+        switch (expr.op) {
+            case UnaryOperator::Preincrement:
+            case UnaryOperator::Predecrement:
+            case UnaryOperator::Postincrement:
+            case UnaryOperator::Postdecrement:
+                addTargets(expr.operand());
+                break;
+            default:
+                break;
+        }
+        visitDefault(expr);
+    }
+
+    void handle(const CallExpression& expr) {
+        // System subroutines can write to any of their arguments (e.g. $sformat, or
+        // array methods that operate on their first argument); user subroutines
+        // only write through their output, inout, and ref arguments.
+        auto args = expr.arguments();
+        if (expr.isSystemCall()) {
+            for (auto arg : args)
+                addTargets(*arg);
+        }
+        else {
+            auto formals = std::get<0>(expr.subroutine)->getArguments();
+            for (size_t i = 0; i < args.size(); i++) {
+                if (i >= formals.size() || formals[i]->direction != ArgumentDirection::In)
+                    addTargets(*args[i]);
+            }
+        }
+
+        if (auto thisClass = expr.thisClass())
+            addTargets(*thisClass);
+
+        visitDefault(expr);
+    }
+
+    void handle(const VariableDeclStatement& stmt) { modified.emplace(&stmt.symbol); }
+
+    void handle(const ForeachLoopStatement& stmt) {
+        for (auto& dim : stmt.loopDims) {
+            if (dim.loopVar)
+                modified.emplace(dim.loopVar);
+        }
+        visitDefault(stmt);
+    }
+};
+
+// Marks the largest subexpressions in a loop whose values don't depend on anything
+// the loop modifies, so that evaluation can compute them once per loop execution.
+struct LoopInvariantMarker : public ASTVisitor<LoopInvariantMarker, true, true> {
+    const flat_hash_set<const Symbol*>& modified;
+
+    explicit LoopInvariantMarker(const flat_hash_set<const Symbol*>& modified) :
+        modified(modified) {}
+
+    template<typename T>
+    void handle(const T& node) {
+        if constexpr (std::is_base_of_v<Expression, T>) {
+            if (isWorthCaching(node) && isInvariant(node)) {
+                node.isLoopInvariant = true;
+                return;
+            }
+        }
+        visitDefault(node);
+    }
+
+    bool isInvariant(const Expression& expr) const {
+        switch (expr.kind) {
+            case ExpressionKind::IntegerLiteral:
+            case ExpressionKind::RealLiteral:
+            case ExpressionKind::TimeLiteral:
+            case ExpressionKind::UnbasedUnsizedIntegerLiteral:
+            case ExpressionKind::StringLiteral:
+                return true;
+            case ExpressionKind::NamedValue:
+                return isInvariant(expr.as<NamedValueExpression>().symbol);
+            case ExpressionKind::UnaryOp: {
+                auto& op = expr.as<UnaryExpression>();
+                switch (op.op) {
+                    case UnaryOperator::Preincrement:
+                    case UnaryOperator::Predecrement:
+                    case UnaryOperator::Postincrement:
+                    case UnaryOperator::Postdecrement:
+                        return false;
+                    default:
+                        return isInvariant(op.operand());
+                }
+            }
+            case ExpressionKind::BinaryOp: {
+                auto& op = expr.as<BinaryExpression>();
+                return isInvariant(op.left()) && isInvariant(op.right());
+            }
+            case ExpressionKind::ConditionalOp: {
+                auto& op = expr.as<ConditionalExpression>();
+                return isInvariant(op.pred()) && isInvariant(op.left()) &&
+                       isInvariant(op.right());
+            }
+            case ExpressionKind::Conversion:
+                return isInvariant(expr.as<ConversionExpression>().operand());
+            case ExpressionKind::Concatenation:
+                for (auto op : expr.as<ConcatenationExpression>().operands()) {
+                    if (!isInvariant(*op))
+                        return false;
+                }
+                return true;
+            case ExpressionKind::Replication: {
+                auto& op = expr.as<ReplicationExpression>();
+                return isInvariant(op.count()) && isInvariant(op.concat());
+            }
+            case ExpressionKind::ElementSelect: {
+                auto& op = expr.as<ElementSelectExpression>();
+                return isInvariant(op.value()) && isInvariant(op.selector());
+            }
+            case ExpressionKind::RangeSelect: {
+                auto& op = expr.as<RangeSelectExpression>();
+                return isInvariant(op.value()) && isInvariant(op.left()) &&
+                       isInvariant(op.right());
+            }
+            case ExpressionKind::MemberAccess:
+                return isInvariant(expr.as<MemberAccessExpression>().value());
+            default:
+                return false;
+        }
+    }
+
+    bool isInvariant(const ValueSymbol& symbol) const {
+        switch (symbol.kind) {
+            case SymbolKind::Parameter:
+            case SymbolKind::EnumValue:
+                return true;
+            case SymbolKind::FormalArgument:
+                if (symbol.as<FormalArgumentSymbol>().direction != ArgumentDirection::In)
+                    return false;
+                [[fallthrough]];
+            case SymbolKind::Variable:
+                // Static variables can be changed by calls made from within the loop,
+                // and class handles don't say anything about the object's contents.
+                return static_cast<const VariableSymbol&>(symbol).lifetime ==
+                           VariableLifetime::Automatic &&
+                       !symbol.getType().isClass() && !modified.count(&symbol);
+            default:
+                return false;
+        }
+    }
+
+    // Only operators are worth caching; plain names and literals
+    // are already as cheap to evaluate as a cache lookup.
+    static bool isWorthCaching(const Expression& expr) {
+        const Expression* e = &expr;
+        while (e->kind == ExpressionKind::Conversion)
+            e = &e->as<ConversionExpression>().operand();
+
+        switch (e->kind) {
+            case ExpressionKind::UnaryOp:
+            case ExpressionKind::BinaryOp:
+            case ExpressionKind::ConditionalOp:
+            case ExpressionKind::Concatenation:
+            case ExpressionKind::Replication:
+            case ExpressionKind::ElementSelect:
+            case ExpressionKind::RangeSelect:
+            case ExpressionKind::MemberAccess:
+                return true;
+            default:
+                return false;
+        }
+    }
+};
+
+// Finds loop-invariant expressions in the parts of a loop that run on every
+// iteration: the loop's own per-iteration expressions and its body.
+void markLoopInvariants(const Statement& loop, std::initializer_list<const Expression*> loopExprs,
+                        span<const Expression* const> steps, const Statement& body) {
+    LoopModifiedVisitor modifiedVisitor;
+    loop.visit(modifiedVisitor);
+
+    LoopInvariantMarker marker(modifiedVisitor.modified);
+    for (auto expr : loopExprs) {
+        if (expr)
+            expr->visit(marker);
+    }
+    for (auto expr : steps)
+        expr->visit(marker);
+    body.visit(marker);
+}
+
 } // namespace
 
 namespace slang {
@@ -1204,6 +1415,8 @@ Statement& ForLoopStatement::fromSyntax(Compilation& compilation,
 
     if (anyBad || stopExpr.bad() || bodyStmt.bad())
         return badStmt(compilation, result);
+
+    markLoopInvariants(*result, { result->stopExpr }, result->steps, bodyStmt);
     return *result;
 }
 
@@ -1213,6 +1426,7 @@ ER ForLoopStatement::evalImpl(EvalContext& context) const {
             return ER::Fail;
     }
 
+    LoopCacheGuard loopCache(context);
     while (true) {
         if (stopExpr) {
             auto result = stopExpr->eval(context);
@@ -1294,6 +1508,8 @@ Statement& RepeatLoopStatement::fromSyntax(Compilation& compilation,
 
     if (bad || bodyStmt.bad())
         return badStmt(compilation, result);
+
+    markLoopInvariants(*result, {}, {}, bodyStmt);
     return *result;
 }
 
@@ -1313,6 +1529,7 @@ ER RepeatLoopStatement::evalImpl(EvalContext& context) const {
         }
     }
 
+    LoopCacheGuard loopCache(context);
     int64_t c = *oc;
     for (int64_t i = 0; i < c; i++) {
         ER result = body.eval(context);
@@ -1425,6 +1642,8 @@ Statement& ForeachLoopStatement::fromSyntax(Compilation& compilation,
 
     if (bad || bodyStmt.bad())
         return badStmt(compilation, result);
+
+    markLoopInvariants(*result, {}, {}, bodyStmt);
     return *result;
 }
 
@@ -1437,6 +1656,7 @@ ER ForeachLoopStatement::evalImpl(EvalContext& context) const {
     if (!cv)
         return ER::Fail;
 
+    LoopCacheGuard loopCache(context);
     ER result = evalRecursive(context, cv, loopDims);
     if (result == ER::Break || result == ER::Continue)
         return ER::Success;
@@ -1494,8 +1714,8 @@ ER ForeachLoopStatement::evalRecursive(EvalContext& context, const ConstantValue
     else if (cv.isString()) {
         ASSERT(currDims.size() == 1);
 
-        auto& str = cv.str();
-        for (size_t i = 0; i < str.size(); i++) {
+        size_t size = cv.svString().size();
+        for (size_t i = 0; i < size; i++) {
             *local = SVInt(32, i, true);
 
             ER result = body.eval(context);
@@ -1576,10 +1796,13 @@ Statement& WhileLoopStatement::fromSyntax(Compilation& compilation,
 
     if (bad || bodyStmt.bad())
         return badStmt(compilation, result);
+
+    markLoopInvariants(*result, { &condExpr }, {}, bodyStmt);
     return *result;
 }
 
 ER WhileLoopStatement::evalImpl(EvalContext& context) const {
+    LoopCacheGuard loopCache(context);
     while (true) {
         auto cv = cond.eval(context);
         if (cv.bad())
@@ -1625,10 +1848,13 @@ Statement& DoWhileLoopStatement::fromSyntax(Compilation& compilation,
 
     if (bad || bodyStmt.bad())
         return badStmt(compilation, result);
+
+    markLoopInvariants(*result, { &condExpr }, {}, bodyStmt);
     return *result;
 }
 
 ER DoWhileLoopStatement::evalImpl(EvalContext& context) const {
+    LoopCacheGuard loopCache(context);
     while (true) {
         ER result = body.eval(context);
         if (result != ER::Success) {
@@ -1668,10 +1894,12 @@ Statement& ForeverLoopStatement::fromSyntax(Compilation& compilation,
     if (bodyStmt.bad())
         return badStmt(compilation, result);
 
+    markLoopInvariants(*result, {}, {}, bodyStmt);
     return *result;
 }
 
 ER ForeverLoopStatement::evalImpl(EvalContext& context) const {
+    LoopCacheGuard loopCache(context);
     while (true) {
         ER result = body.eval(context);
         if (result != ER::Success) {
@@ -1761,10 +1989,19 @@ Statement& ExpressionStatement::fromSyntax(Compilation& compilation,
     return *result;
 }
 
+static bool isConstantSystemTask(const Expression& expr) {
+    if (expr.kind != ExpressionKind::Call)
+        return false;
+
+    auto& call = expr.as<CallExpression>();
+    return call.isSystemCall() && std::get<1>(call.subroutine).subroutine->hasConstantEval;
+}
+
 ER ExpressionStatement::evalImpl(EvalContext& context) const {
-    // Skip system task invocations.
+    // Skip system task invocations, unless they know how to evaluate themselves.
     if (expr.kind == ExpressionKind::Call &&
-        expr.as<CallExpression>().getSubroutineKind() == SubroutineKind::Task) {
+        expr.as<CallExpression>().getSubroutineKind() == SubroutineKind::Task &&
+        !isConstantSystemTask(expr)) {
         return ER::Success;
     }
 
@@ -1774,7 +2011,8 @@ ER ExpressionStatement::evalImpl(EvalContext& context) const {
 bool ExpressionStatement::verifyConstantImpl(EvalContext& context) const {
     // Skip system task invocations, but provide a warning.
     if (expr.kind == ExpressionKind::Call && expr.as<CallExpression>().isSystemCall() &&
-        expr.as<CallExpression>().getSubroutineKind() == SubroutineKind::Task) {
+        expr.as<CallExpression>().getSubroutineKind() == SubroutineKind::Task &&
+        !isConstantSystemTask(expr)) {
         context.addDiag(diag::ConstSysTaskIgnored, expr.sourceRange)
             << expr.as<CallExpression>().getSubroutineName();
         return true;
@@ -99,7 +99,7 @@ llvm::Value* CodeGenFunction::emit(MIRValue val) {
 llvm::Value* CodeGenFunction::emitConstant(const Type& type, const ConstantValue& cv) {
     // TODO: other value types
     if (cv.isString()) {
-        auto& str = cv.str();
+        std::string str = cv.str();
         auto gv = codegen.getOrCreateStringConstant(str);
 
         Address addr(gv, llvm::Align(gv->getAlignment()));
@@ -29,7 +29,8 @@ using namespace slang;
 // evaluated members have been realized and we have recorded every diagnostic.
 struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
     DiagnosticVisitor(Compilation& compilation, const size_t& numErrors, uint32_t errorLimit) :
-        compilation(compilation), numErrors(numErrors), errorLimit(errorLimit) {}
+        compilation(compilation), numErrors(numErrors), errorLimit(errorLimit),
+        hierarchyOnly(compilation.getOptions().hierarchyOnly) {}
 
     template<typename T>
     void handle(const T& symbol) {
@@ -38,14 +39,15 @@ struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
 
     template<typename T>
     bool handleDefault(const T& symbol) {
-        if (numErrors > errorLimit)
+        if (numErrors > errorLimit || compilation.isOverBudget())
             return false;
 
         if constexpr (std::is_base_of_v<Symbol, T>) {
             auto declaredType = symbol.getDeclaredType();
             if (declaredType) {
                 declaredType->getType();
-                declaredType->getInitializer();
+                if (!hierarchyOnly)
+                    declaredType->getInitializer();
             }
 
             if constexpr (std::is_same_v<ParameterSymbol, T> ||
@@ -53,12 +55,16 @@ struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
                 symbol.getValue();
             }
 
-            for (auto attr : compilation.getAttributes(symbol))
-                attr->getValue();
+            if (!hierarchyOnly) {
+                for (auto attr : compilation.getAttributes(symbol))
+                    attr->getValue();
+            }
         }
 
-        if constexpr (is_detected_v<getBody_t, T>)
-            symbol.getBody().visit(*this);
+        if constexpr (is_detected_v<getBody_t, T>) {
+            if (!hierarchyOnly)
+                symbol.getBody().visit(*this);
+        }
 
         visitDefault(symbol);
         return true;
@@ -77,7 +83,7 @@ struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
     }
 
     void handle(const ContinuousAssignSymbol& symbol) {
-        if (!handleDefault(symbol))
+        if (!handleDefault(symbol) || hierarchyOnly)
             return;
         symbol.getAssignment();
     }
@@ -113,27 +119,31 @@ struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
     }
 
     void handle(const NetSymbol& symbol) {
-        if (!handleDefault(symbol))
+        if (!handleDefault(symbol) || hierarchyOnly)
             return;
 
         symbol.getDelay();
     }
 
     void handle(const ConstraintBlockSymbol& symbol) {
-        if (!handleDefault(symbol))
+        if (!handleDefault(symbol) || hierarchyOnly)
             return;
 
         symbol.getConstraints();
     }
 
     void handle(const InstanceSymbol& symbol) {
-        if (numErrors > errorLimit)
+        if (numErrors > errorLimit ||
+            compilation.checkBudget(*symbol.getParentScope(), symbol.location)) {
             return;
+        }
 
         instanceCount[&symbol.getDefinition()]++;
         symbol.resolvePortConnections();
-        for (auto attr : compilation.getAttributes(symbol))
-            attr->getValue();
+        if (!hierarchyOnly) {
+            for (auto attr : compilation.getAttributes(symbol))
+                attr->getValue();
+        }
 
         // Instance bodies are all the same, so if we've visited this one
         // already don't bother doing it again.
@@ -202,6 +212,7 @@ struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
     flat_hash_set<const InstanceBodySymbol*> visitedInstanceBodies;
     uint32_t errorLimit;
     uint32_t hierarchyDepth = 0;
+    bool hierarchyOnly;
     SmallVectorSized<const GenericClassDefSymbol*, 8> genericClasses;
 };
 
@@ -278,6 +289,10 @@ namespace slang {
 Compilation::Compilation(const Bag& options) :
     options(options.getOrDefault<CompilationOptions>()), tempDiag({}, {}) {
 
+    startTime = std::chrono::steady_clock::now();
+    if (this->options.memoryLimit)
+        setByteLimit(size_t(std::min<uint64_t>(this->options.memoryLimit, SIZE_MAX)));
+
     // Construct all built-in types.
     bitType = emplace<ScalarType>(ScalarType::Bit);
     logicType = emplace<ScalarType>(ScalarType::Logic);
@@ -855,8 +870,15 @@ const Diagnostics& Compilation::getSemanticDiagnostics() {
     getRoot().visit(visitor);
     visitor.finalize();
 
+    // If elaboration was cut short, the usage information gathered by the
+    // visitor is incomplete, so skip the checks below that rely on it.
+    const bool halted = isOverBudget();
+
     // Report on unused out-of-block definitions. These are always a real error.
     for (auto& [key, val] : outOfBlockMethods) {
+        if (halted)
+            break;
+
         auto& [syntax, index, used] = val;
         if (!used) {
             auto& [className, methodName, scope] = key;
@@ -880,7 +902,7 @@ const Diagnostics& Compilation::getSemanticDiagnostics() {
     }
 
     // Report on unused definitions.
-    if (!options.suppressUnused) {
+    if (!options.suppressUnused && !halted) {
         for (auto def : unreferencedDefs) {
             // If this is an interface, it may have been referenced in a port.
             if (usedIfacePorts.find(def) != usedIfacePorts.end())
@@ -965,6 +987,203 @@ const Diagnostics& Compilation::getAllDiagnostics() {
     return *cachedAllDiagnostics;
 }
 
+template<typename TMap>
+static size_t approxMapBytes(const TMap& map) {
+    return map.bucket_count() * (sizeof(typename TMap::value_type) + 1);
+}
+
+template<typename TMap>
+static void releaseMap(TMap& map, Compilation::CompactionStats& stats) {
+    stats.bytesReclaimed += approxMapBytes(map);
+    stats.entriesReleased += map.size();
+    TMap().swap(map);
+}
+
+Compilation::CompactionStats Compilation::compact() {
+    // Visiting everything to collect diagnostics forces all deferred members,
+    // statements, and expressions in the design to be bound.
+    getAllDiagnostics();
+
+    CompactionStats stats;
+    releaseUnreferencedTrees(stats);
+
+    for (auto& [key, diagList] : diagMap)
+        stats.bytesReclaimed += diagList.capacity() * sizeof(Diagnostic);
+    releaseMap(diagMap, stats);
+
+    for (auto& [scope, index] : memberIndexes) {
+        stats.bytesReclaimed += sizeof(Scope::MemberIndex) +
+                                (index->members.capacity() + index->byKind.capacity()) *
+                                    sizeof(const Symbol*) +
+                                approxMapBytes(index->kindRanges);
+    }
+    releaseMap(memberIndexes, stats);
+
+    for (auto& [def, binds] : bindDirectivesByDef)
+        stats.bytesReclaimed += binds.capacity() * sizeof(const BindDirectiveSyntax*);
+    releaseMap(bindDirectivesByDef, stats);
+    releaseMap(seenBindDirectives, stats);
+    releaseMap(globalInstantiations, stats);
+
+    return stats;
+}
+
+void Compilation::releaseUnreferencedTrees(CompactionStats& stats) {
+    if (!sourceManager)
+        return;
+
+    // Collect every buffer that a diagnostic points into, following macro expansions
+    // and include chains back to the file that contains them. Trees that cover one
+    // of these buffers are kept so that the diagnostics can still be reported.
+    flat_hash_set<BufferID> diagBuffers;
+    auto addDiagLocation = [&](SourceLocation location) {
+        if (!location || location == SourceLocation::NoLocation)
+            return;
+
+        location = sourceManager->getFullyOriginalLoc(location);
+        while (location && diagBuffers.emplace(location.buffer()).second)
+            location = sourceManager->getIncludedFrom(location.buffer());
+    };
+
+    for (auto& diag : *cachedAllDiagnostics) {
+        addDiagLocation(diag.location);
+        for (auto& note : diag.notes())
+            addDiagLocation(note.location);
+    }
+
+    auto inDiagBuffer = [&](SourceLocation location) {
+        location = sourceManager->getFullyOriginalLoc(location);
+        return diagBuffers.find(location.buffer()) != diagBuffers.end();
+    };
+
+    flat_hash_map<const SyntaxNode*, const Definition*> defsBySyntax;
+    for (auto& [key, def] : definitionMap)
+        defsBySyntax.emplace(&def->syntax, def.get());
+
+    auto isReleasable = [&](const SyntaxNode& member) {
+        switch (member.kind) {
+            case SyntaxKind::ModuleDeclaration:
+            case SyntaxKind::InterfaceDeclaration:
+            case SyntaxKind::ProgramDeclaration:
+                break;
+            default:
+                return false;
+        }
+
+        auto it = defsBySyntax.find(&member);
+        if (it == defsBySyntax.end() || usedIfacePorts.find(it->second) != usedIfacePorts.end())
+            return false;
+
+        auto def = it->second;
+        if (std::find(unreferencedDefs.begin(), unreferencedDefs.end(), def) ==
+            unreferencedDefs.end()) {
+            return false;
+        }
+
+        return !inDiagBuffer(member.getFirstToken().location());
+    };
+
+    auto getTopNode = [](const SyntaxNode* node) {
+        while (node->parent)
+            node = node->parent;
+        return node;
+    };
+
+    flat_hash_set<const SyntaxNode*> releasedRoots;
+    flat_hash_set<const Symbol*> releasedSymbols;
+    for (size_t i = 0; i < syntaxTrees.size(); i++) {
+        // If anyone else holds the tree, dropping our reference frees nothing.
+        auto& tree = syntaxTrees[i];
+        if (tree.use_count() != 1 || !compilationUnits[i]->empty() ||
+            inDiagBuffer(tree->getEOFToken().location())) {
+            continue;
+        }
+
+        bool releasable;
+        auto& node = tree->root();
+        if (node.kind == SyntaxKind::CompilationUnit) {
+            auto& members = node.as<CompilationUnitSyntax>().members;
+            releasable = std::all_of(members.begin(), members.end(),
+                                     [&](auto member) { return isReleasable(*member); });
+        }
+        else {
+            releasable = isReleasable(node);
+        }
+
+        if (releasable) {
+            releasedRoots.emplace(getTopNode(&node));
+            releasedSymbols.emplace(compilationUnits[i]);
+        }
+    }
+
+    if (releasedRoots.empty())
+        return;
+
+    auto inReleasedTree = [&](const SyntaxNode* node) {
+        return releasedRoots.find(getTopNode(node)) != releasedRoots.end();
+    };
+
+    // Remove all definitions declared in the released trees, including nested ones.
+    flat_hash_set<const Definition*> releasedDefs;
+    for (auto it = definitionMap.begin(); it != definitionMap.end();) {
+        auto def = it->second.get();
+        if (!inReleasedTree(&def->syntax)) {
+            ++it;
+            continue;
+        }
+
+        if (auto top = topDefinitions.find(def->name);
+            top != topDefinitions.end() && top->second.first == def) {
+            if (top->second.second)
+                top->second.first = nullptr;
+            else
+                topDefinitions.erase(top);
+        }
+
+        releasedDefs.emplace(def);
+        it = definitionMap.erase(it);
+        stats.entriesReleased++;
+    }
+
+    for (auto it = definitionMetadata.begin(); it != definitionMetadata.end();) {
+        if (inReleasedTree(it->first))
+            it = definitionMetadata.erase(it);
+        else
+            ++it;
+    }
+
+    unreferencedDefs.erase(std::remove_if(unreferencedDefs.begin(), unreferencedDefs.end(),
+                                          [&](auto def) { return releasedDefs.count(def) != 0; }),
+                           unreferencedDefs.end());
+
+    // Drop the placeholder instances created for the unused definitions
+    // along with the compilation units for the released trees.
+    for (auto& member : root->members()) {
+        if (member.kind == SymbolKind::Instance &&
+            releasedDefs.count(&member.as<InstanceSymbol>().getDefinition())) {
+            releasedSymbols.emplace(&member);
+        }
+    }
+    root->removeMembers(releasedSymbols);
+
+    compilationUnits.erase(
+        std::remove_if(compilationUnits.begin(), compilationUnits.end(),
+                       [&](auto unit) { return releasedSymbols.count(unit) != 0; }),
+        compilationUnits.end());
+    root->compilationUnits = compilationUnits;
+
+    for (auto it = syntaxTrees.begin(); it != syntaxTrees.end();) {
+        if (inReleasedTree(&(*it)->root())) {
+            stats.bytesReclaimed += (*it)->allocator().getBytesAllocated();
+            stats.treesReleased++;
+            it = syntaxTrees.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
 void Compilation::addDiagnostics(const Diagnostics& diagnostics) {
     for (auto& diag : diagnostics)
         addDiag(diag);
@@ -1009,6 +1228,51 @@ Diagnostic& Compilation::addDiag(Diagnostic diag) {
     return it->second.back();
 }
 
+bool Compilation::checkBudget() {
+    if (budgetExceeded != BudgetKind::None)
+        return true;
+
+    if (isCancelled()) {
+        budgetExceeded = BudgetKind::Cancelled;
+        return true;
+    }
+
+    if (isOverByteLimit()) {
+        budgetExceeded = BudgetKind::Memory;
+        return true;
+    }
+
+    if (options.timeLimit) {
+        auto elapsed = std::chrono::steady_clock::now() - startTime;
+        if (elapsed > std::chrono::milliseconds(options.timeLimit)) {
+            budgetExceeded = BudgetKind::Time;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Compilation::checkBudget(const Scope& scope, SourceLocation location) {
+    if (!checkBudget())
+        return false;
+
+    if (!budgetReported && budgetExceeded != BudgetKind::Cancelled) {
+        budgetReported = true;
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime);
+
+        auto& diag = scope.addDiag(diag::CompilationBudgetExceeded, location);
+        if (budgetExceeded == BudgetKind::Memory)
+            diag << "memory"sv << std::to_string(options.memoryLimit) + " bytes";
+        else
+            diag << "time"sv << std::to_string(options.timeLimit) + " ms";
+        diag << getBytesAllocated() << elapsed.count();
+    }
+    return true;
+}
+
 const Type& Compilation::getType(SyntaxKind typeKind) const {
     auto it = knownTypes.find(typeKind);
     return it == knownTypes.end() ? *errorType : *it->second;
@@ -1082,6 +1346,27 @@ span<const WildcardImportSymbol*> Compilation::queryImports(Scope::ImportDataInd
     return importData[index];
 }
 
+std::unique_ptr<Scope::MemberIndex>& Compilation::getMemberIndex(const Scope& scope) {
+    return memberIndexes[&scope];
+}
+
+void Compilation::invalidateMemberIndex(const Scope& scope) {
+    if (!memberIndexes.empty())
+        memberIndexes.erase(&scope);
+}
+
+GateTable& Compilation::getOrAddGateTable(const Scope& scope) {
+    auto& table = gateTables[&scope];
+    if (!table)
+        table = std::make_unique<GateTable>(scope);
+    return *table;
+}
+
+const GateTable* Compilation::findGateTable(const Scope& scope) const {
+    auto it = gateTables.find(&scope);
+    return it == gateTables.end() ? nullptr : it->second.get();
+}
+
 void Compilation::parseParamOverrides(flat_hash_map<string_view, const ConstantValue*>& results) {
     if (options.paramOverrides.empty())
         return;
@@ -172,7 +172,7 @@ public:
                 sortTarget(*target->queue());
             }
             else {
-                auto& vec = std::get<ConstantValue::Elements>(target->getVariant());
+                auto& vec = *std::get<ConstantValue::Unpacked>(target->getVariant());
                 sortTarget(vec);
             }
         }
@@ -188,7 +188,7 @@ public:
                 sortTarget(*target->queue());
             }
             else {
-                auto& vec = std::get<ConstantValue::Elements>(target->getVariant());
+                auto& vec = *std::get<ConstantValue::Unpacked>(target->getVariant());
                 sortTarget(vec);
             }
         }
@@ -229,7 +229,7 @@ public:
         if (target->isQueue())
             doReverse(*target->queue());
         else
-            doReverse(std::get<ConstantValue::Elements>(target->getVariant()));
+            doReverse(*std::get<ConstantValue::Unpacked>(target->getVariant()));
 
         return nullptr;
     }
@@ -342,7 +342,7 @@ public:
             if (arr.isQueue())
                 find(*arr.queue());
             else
-                find(std::get<ConstantValue::Elements>(arr.getVariant()));
+                find(*std::get<ConstantValue::Unpacked>(arr.getVariant()));
         }
 
         return results;
@@ -244,7 +244,7 @@ protected:
             return {};
 
         if (cv.isString())
-            return cv.str().size();
+            return cv.svString().size();
 
         // This silly collection of std::moves is to avoid copying the array out
         // when the constant value owning it will not survive this function.
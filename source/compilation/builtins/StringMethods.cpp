@@ -22,7 +22,7 @@ public:
         if (!val)
             return nullptr;
 
-        return SVInt(32, val.str().length(), true);
+        return SVInt(32, val.svString().size(), true);
     }
 };
 
@@ -67,7 +67,7 @@ public:
         if (!strCv || !indexCv)
             return nullptr;
 
-        const std::string& str = strCv.str();
+        string_view str = strCv.svString().view();
         int32_t index = indexCv.integer().as<int32_t>().value();
         if (index < 0 || size_t(index) >= str.length())
             return SVInt(8, 0, false);
@@ -118,8 +118,8 @@ public:
         if (!lhsCv || !rhsCv)
             return nullptr;
 
-        std::string& lhs = lhsCv.str();
-        std::string& rhs = rhsCv.str();
+        std::string lhs = std::move(lhsCv).str();
+        std::string rhs = std::move(rhsCv).str();
 
         int result;
         if (ignoreCase) {
@@ -161,14 +161,14 @@ public:
         if (!strCv || !leftCv || !rightCv)
             return nullptr;
 
-        const std::string& str = strCv.str();
+        string_view str = strCv.svString().view();
         int32_t left = leftCv.integer().as<int32_t>().value();
         int32_t right = rightCv.integer().as<int32_t>().value();
         if (left < 0 || right < left || size_t(right) >= str.length())
             return ""s;
 
         int32_t count = right - left + 1;
-        return str.substr(size_t(left), size_t(count));
+        return std::string(str.substr(size_t(left), size_t(count)));
     }
 };
 
@@ -5,11 +5,14 @@
 // File is under the MIT license; see LICENSE for details
 //------------------------------------------------------------------------------
 #include "slang/binding/FormatHelpers.h"
+#include "slang/binding/LValue.h"
 #include "slang/binding/MiscExpressions.h"
 #include "slang/binding/SystemSubroutine.h"
 #include "slang/compilation/Compilation.h"
+#include "slang/diagnostics/ConstEvalDiags.h"
 #include "slang/diagnostics/SysFuncsDiags.h"
 #include "slang/mir/Procedure.h"
+#include "slang/numeric/MemoryFile.h"
 #include "slang/symbols/InstanceSymbols.h"
 #include "slang/syntax/AllSyntax.h"
 
@@ -188,10 +191,12 @@ public:
     }
 };
 
-class ReadWriteMemTask : public SystemTaskBase {
+class ReadWriteMemTask : public SystemSubroutine {
 public:
-    ReadWriteMemTask(const std::string& name, bool isInput) :
-        SystemTaskBase(name), isInput(isInput) {}
+    ReadWriteMemTask(const std::string& name, bool isInput, bool isHex) :
+        SystemSubroutine(name, SubroutineKind::Task), isInput(isInput), isHex(isHex) {
+        hasConstantEval = isInput;
+    }
 
     const Type& checkArguments(const BindContext& context, const Args& args, SourceRange range,
                                const Expression*) const final {
@@ -237,8 +242,139 @@ public:
         return comp.getVoidType();
     }
 
+    ConstantValue eval(EvalContext& context, const Args& args,
+                       const CallExpression::SystemCallInfo&) const final {
+        if (!isInput)
+            return nullptr;
+
+        auto fileName = args[0]->eval(context);
+        if (!fileName)
+            return nullptr;
+
+        MemoryFile::Options options;
+        options.isHex = isHex;
+        for (size_t i = 2; i < args.size(); i++) {
+            auto cv = args[i]->eval(context);
+            if (!cv)
+                return nullptr;
+
+            auto addr = cv.integer().as<uint64_t>();
+            if (!addr) {
+                context.addDiag(diag::ConstEvalReadMemFailed, args[i]->sourceRange)
+                    << fileName.convertToStr().str() << "invalid address argument"sv;
+                return nullptr;
+            }
+
+            (i == 2 ? options.start : options.finish) = *addr;
+        }
+
+        auto lval = args[1]->evalLValue(context);
+        if (!lval)
+            return nullptr;
+
+        auto target = lval.resolve();
+        if (!target)
+            return nullptr;
+
+        const Type& type = args[1]->type->getCanonicalType();
+        const Type& elemType = *type.getArrayElementType();
+        if (!elemType.isIntegral()) {
+            context.addDiag(diag::ConstEvalReadMemFailed, args[1]->sourceRange)
+                << fileName.convertToStr().str() << "multi-dimensional memories are not supported"sv;
+            return nullptr;
+        }
+
+        options.wordWidth = elemType.getBitWidth();
+        bool isSigned = elemType.isSigned();
+        bool isFourState = elemType.isFourState();
+        auto convert = [&](SVInt&& value) {
+            value.setSigned(isSigned);
+            if (!isFourState)
+                value.flattenUnknowns();
+            return ConstantValue(std::move(value));
+        };
+
+        std::string path = fileName.convertToStr().str();
+        MemoryFile::Result result;
+        switch (type.kind) {
+            case SymbolKind::FixedSizeUnpackedArrayType: {
+                ConstantRange range = type.getFixedRange();
+                if (range.lower() < 0) {
+                    context.addDiag(diag::ConstEvalReadMemFailed, args[1]->sourceRange)
+                        << path << "memories with negative addresses are not supported"sv;
+                    return nullptr;
+                }
+
+                options.lowAddress = uint64_t(range.lower());
+                options.highAddress = uint64_t(range.upper());
+
+                // Unpacked arrays are stored reversed in memory, so reverse the range here.
+                ConstantRange storage = range.reverse();
+                auto elems = target->elements();
+                result = MemoryFile::load(path, options, [&](uint64_t addr, SVInt&& value) {
+                    elems[size_t(storage.translateIndex(int32_t(addr)))] = convert(std::move(value));
+                });
+                break;
+            }
+            case SymbolKind::AssociativeArrayType: {
+                bitwidth_t indexWidth = 64;
+                bool indexSigned = false;
+                if (auto indexType = type.getAssociativeIndexType()) {
+                    indexWidth = indexType->getBitWidth();
+                    indexSigned = indexType->isSigned();
+                }
+
+                options.highAddress = indexWidth >= 64 ? UINT64_MAX : (1ull << indexWidth) - 1;
+
+                auto& map = *target->map();
+                result = MemoryFile::load(path, options, [&](uint64_t addr, SVInt&& value) {
+                    map[SVInt(indexWidth, addr, indexSigned)] = convert(std::move(value));
+                });
+                break;
+            }
+            case SymbolKind::QueueType: {
+                auto& queue = *target->queue();
+                if (queue.empty())
+                    return ConstantValue::NullPlaceholder{};
+
+                options.highAddress = queue.size() - 1;
+                result = MemoryFile::load(path, options, [&](uint64_t addr, SVInt&& value) {
+                    queue[size_t(addr)] = convert(std::move(value));
+                });
+                break;
+            }
+            default: {
+                auto elems = target->elements();
+                if (elems.empty())
+                    return ConstantValue::NullPlaceholder{};
+
+                options.highAddress = elems.size() - 1;
+                result = MemoryFile::load(path, options, [&](uint64_t addr, SVInt&& value) {
+                    elems[size_t(addr)] = convert(std::move(value));
+                });
+                break;
+            }
+        }
+
+        if (!result) {
+            std::string msg(MemoryFile::errorToString(result.error));
+            if (result.line)
+                msg += " (line " + std::to_string(result.line) + ")";
+
+            context.addDiag(diag::ConstEvalReadMemFailed, args[0]->sourceRange) << path << msg;
+            return nullptr;
+        }
+
+        return ConstantValue::NullPlaceholder{};
+    }
+
+    bool verifyConstant(EvalContext& context, const Args&, SourceRange range) const final {
+        return isInput || notConst(context, range);
+    }
+
 private:
     bool isInput;
+    bool isHex;
 };
 
 class PrintTimeScaleTask : public SystemTaskBase {
@@ -513,10 +649,10 @@ void registerSystemTasks(Compilation& c) {
     auto int_t = &c.getIntType();
     auto string_t = &c.getStringType();
 
-    c.addSystemSubroutine(std::make_unique<ReadWriteMemTask>("$readmemb", true));
-    c.addSystemSubroutine(std::make_unique<ReadWriteMemTask>("$readmemh", true));
-    c.addSystemSubroutine(std::make_unique<ReadWriteMemTask>("$writememb", false));
-    c.addSystemSubroutine(std::make_unique<ReadWriteMemTask>("$writememh", false));
+    c.addSystemSubroutine(std::make_unique<ReadWriteMemTask>("$readmemb", true, false));
+    c.addSystemSubroutine(std::make_unique<ReadWriteMemTask>("$readmemh", true, true));
+    c.addSystemSubroutine(std::make_unique<ReadWriteMemTask>("$writememb", false, false));
+    c.addSystemSubroutine(std::make_unique<ReadWriteMemTask>("$writememh", false, true));
     c.addSystemSubroutine(std::make_unique<SimpleSystemTask>("$system", *int_t, 0,
                                                              std::vector<const Type*>{ string_t }));
 
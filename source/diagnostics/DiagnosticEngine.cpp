@@ -198,7 +198,7 @@ void DiagnosticEngine::issueImpl(const Diagnostic& diagnostic, DiagnosticSeverit
                 loc = sourceManager.getExpansionLoc(loc);
             }
 
-            if (checkMacroArgRanges(*this, prevLoc, diagnostic.ranges))
+            if (checkMacroArgRanges(*this, prevLoc, diagnostic.ranges()))
                 ignoreUntil = expansionLocs.size();
         }
 
@@ -209,7 +209,7 @@ void DiagnosticEngine::issueImpl(const Diagnostic& diagnostic, DiagnosticSeverit
 
     ReportedDiagnostic report(diagnostic);
     report.expansionLocs = span<SourceLocation>(expansionLocs).subspan(ignoreUntil);
-    report.ranges = diagnostic.ranges;
+    report.ranges = diagnostic.ranges();
     report.location = loc;
     report.severity = severity;
     report.formattedMessage = message;
@@ -220,7 +220,7 @@ void DiagnosticEngine::issueImpl(const Diagnostic& diagnostic, DiagnosticSeverit
 
     // Notes are ignored if location is "NoLocation" since they frequently make no
     // sense without location information.
-    for (const Diagnostic& note : diagnostic.notes) {
+    for (const Diagnostic& note : diagnostic.notes()) {
         if (note.location != SourceLocation::NoLocation)
             issue(note);
     }
@@ -228,7 +228,7 @@ void DiagnosticEngine::issueImpl(const Diagnostic& diagnostic, DiagnosticSeverit
 
 std::string DiagnosticEngine::formatMessage(const Diagnostic& diag) const {
     // If we have no arguments, the format string is the entire message.
-    if (diag.args.empty())
+    if (diag.args().empty())
         return std::string(getMessage(diag.code));
 
     // Let each formatter have a look at the diagnostic before we begin.
@@ -237,7 +237,7 @@ std::string DiagnosticEngine::formatMessage(const Diagnostic& diag) const {
 
     // Dynamically build up the list of arguments to pass to the formatting routines.
     fmt::dynamic_format_arg_store<fmt::format_context> args;
-    for (auto& arg : diag.args) {
+    for (auto& arg : diag.args()) {
         // Unwrap the argument type (stored as a variant).
         std::visit(
             [&](auto&& t) {
@@ -453,6 +453,12 @@ Diagnostics DiagnosticEngine::setWarningOptions(span<const std::string> options)
 
 Diagnostics DiagnosticEngine::setMappingsFromPragmas() {
     Diagnostics diags;
+    diagMappings.clear();
+
+    // The points at which each diagnostic's severity changes in each buffer,
+    // in offset order. An unset severity reverts to the default.
+    using ChangePoint = std::pair<size_t, optional<DiagnosticSeverity>>;
+    flat_hash_map<std::tuple<DiagCode, BufferID>, std::vector<ChangePoint>> changes;
 
     sourceManager.visitDiagnosticDirectives([&](BufferID buffer, auto& directives) {
         // Store the state of diagnostics each time the user pushes,
@@ -461,7 +467,7 @@ Diagnostics DiagnosticEngine::setMappingsFromPragmas() {
         mappingStack.emplace_back();
 
         auto noteDiag = [&](DiagCode code, auto& directive) {
-            diagMappings[code][buffer].emplace_back(directive.offset, directive.severity);
+            changes[{ code, buffer }].emplace_back(directive.offset, directive.severity);
             mappingStack.back()[code] = directive.severity;
         };
 
@@ -479,11 +485,11 @@ Diagnostics DiagnosticEngine::setMappingsFromPragmas() {
                 // If there is no previous value, they go back to the default (unset).
                 auto& prev = mappingStack[mappingStack.size() - 2];
                 for (auto [code, _] : mappingStack.back()) {
-                    auto& mappings = diagMappings[code][buffer];
+                    auto& points = changes[{ code, buffer }];
                     if (auto it = prev.find(code); it != prev.end())
-                        mappings.emplace_back(directive.offset, it->second);
+                        points.emplace_back(directive.offset, it->second);
                     else
-                        mappings.emplace_back(directive.offset, std::nullopt);
+                        points.emplace_back(directive.offset, std::nullopt);
                 }
                 mappingStack.pop_back();
             }
@@ -507,29 +513,52 @@ Diagnostics DiagnosticEngine::setMappingsFromPragmas() {
         }
     });
 
+    // Turn the change points into a sorted list of regions, dropping the ones
+    // where the default applies and merging neighbors with the same severity.
+    for (auto& [key, points] : changes) {
+        std::vector<DiagnosticMapping> mappings;
+        for (size_t i = 0; i < points.size(); i++) {
+            auto [start, severity] = points[i];
+            size_t end = i + 1 < points.size() ? points[i + 1].first : SIZE_MAX;
+            if (!severity || start == end)
+                continue;
+
+            if (!mappings.empty() && mappings.back().end == start &&
+                mappings.back().severity == *severity) {
+                mappings.back().end = end;
+            }
+            else {
+                mappings.push_back({ start, end, *severity });
+            }
+        }
+
+        if (!mappings.empty())
+            diagMappings.emplace(key, std::move(mappings));
+    }
+
     return diags;
 }
 
 optional<DiagnosticSeverity> DiagnosticEngine::findMappedSeverity(DiagCode code,
                                                                   SourceLocation location) const {
-    auto byCode = diagMappings.find(code);
-    if (byCode == diagMappings.end())
+    if (diagMappings.empty())
         return std::nullopt;
 
     SourceLocation fileLoc = sourceManager.getFullyExpandedLoc(location);
-    auto byBuffer = byCode->second.find(fileLoc.buffer());
-    if (byBuffer == byCode->second.end())
+    auto it = diagMappings.find({ code, fileLoc.buffer() });
+    if (it == diagMappings.end())
         return std::nullopt;
 
-    const std::vector<DiagnosticMapping>& mappings = byBuffer->second;
-    auto byOffset = std::lower_bound(
-        mappings.begin(), mappings.end(), fileLoc.offset(),
-        [](const DiagnosticMapping& mapping, size_t off) { return mapping.offset < off; });
+    const std::vector<DiagnosticMapping>& mappings = it->second;
+    size_t offset = fileLoc.offset();
+    auto mapping = std::lower_bound(
+        mappings.begin(), mappings.end(), offset,
+        [](const DiagnosticMapping& mapping, size_t off) { return mapping.end < off; });
 
-    if (byOffset == mappings.begin())
+    if (mapping == mappings.end() || mapping->start >= offset)
         return std::nullopt;
 
-    return (--byOffset)->severity;
+    return mapping->severity;
 }
 
 } // namespace slang
@@ -13,6 +13,21 @@ namespace slang {
 // Defined in the generated DiagCode.cpp file.
 DiagnosticSeverity getDefaultSeverity(DiagCode code);
 
+// Out-of-line payload for a diagnostic. Most diagnostics have only a handful of
+// arguments and a single highlight range, so those get some inline capacity to
+// keep each diagnostic to a single heap allocation.
+struct Diagnostic::Storage {
+    SmallVectorSized<Arg, 2> args;
+    SmallVectorSized<SourceRange, 2> ranges;
+    std::vector<Diagnostic> notes;
+
+    Storage() = default;
+    Storage(const Storage& other) : notes(other.notes) {
+        args.appendRange(other.args);
+        ranges.appendRange(other.ranges);
+    }
+};
+
 Diagnostic::Diagnostic(DiagCode code, SourceLocation location) noexcept :
     code(code), location(location) {
 }
@@ -25,52 +40,83 @@ bool Diagnostic::isError() const {
     return getDefaultSeverity(code) >= DiagnosticSeverity::Error;
 }
 
+span<const Diagnostic::Arg> Diagnostic::args() const {
+    if (!storage)
+        return {};
+    return storage->args;
+}
+
+span<const SourceRange> Diagnostic::ranges() const {
+    if (!storage)
+        return {};
+    return storage->ranges;
+}
+
+span<const Diagnostic> Diagnostic::notes() const {
+    if (!storage)
+        return {};
+    return storage->notes;
+}
+
+bool Diagnostic::sharesStorageWith(const Diagnostic& other) const {
+    return storage && storage == other.storage;
+}
+
+Diagnostic::Storage& Diagnostic::mutableStorage() {
+    if (!storage)
+        storage = std::make_shared<Storage>();
+    else if (storage.use_count() > 1)
+        storage = std::make_shared<Storage>(*storage);
+    return *storage;
+}
+
 Diagnostic& Diagnostic::addNote(DiagCode noteCode, SourceLocation noteLocation) {
     ASSERT(noteLocation);
+    auto& notes = mutableStorage().notes;
     notes.emplace_back(noteCode, noteLocation);
     return notes.back();
 }
 
 Diagnostic& Diagnostic::addNote(const Diagnostic& diag) {
+    auto& notes = mutableStorage().notes;
     notes.emplace_back(diag);
     return notes.back();
 }
 
-Diagnostic& Diagnostic::operator<<(const std::string& arg) {
-    args.emplace_back(arg);
+Diagnostic& Diagnostic::addArg(Arg arg) {
+    mutableStorage().args.emplace(std::move(arg));
     return *this;
 }
 
+Diagnostic& Diagnostic::operator<<(const std::string& arg) {
+    return addArg(arg);
+}
+
 Diagnostic& Diagnostic::operator<<(string_view arg) {
-    args.emplace_back(std::string(arg));
-    return *this;
+    return addArg(std::string(arg));
 }
 
 Diagnostic& Diagnostic::operator<<(SourceRange range) {
     ASSERT(range.start());
     ASSERT(range.end());
-    ranges.push_back(range);
+    mutableStorage().ranges.append(range);
     return *this;
 }
 
 Diagnostic& Diagnostic::operator<<(const ConstantValue& arg) {
-    args.emplace_back(arg);
-    return *this;
+    return addArg(arg);
 }
 
 Diagnostic& Diagnostic::operator<<(char arg) {
-    args.emplace_back(std::string(1, arg));
-    return *this;
+    return addArg(std::string(1, arg));
 }
 
 Diagnostic& Diagnostic::operator<<(real_t arg) {
-    args.emplace_back(ConstantValue(arg));
-    return *this;
+    return addArg(ConstantValue(arg));
 }
 
 Diagnostic& Diagnostic::operator<<(shortreal_t arg) {
-    args.emplace_back(ConstantValue(arg));
-    return *this;
+    return addArg(ConstantValue(arg));
 }
 
 Diagnostic& Diagnostics::add(DiagCode code, SourceLocation location) {
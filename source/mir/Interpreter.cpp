@@ -0,0 +1,523 @@
+//------------------------------------------------------------------------------
+// Interpreter.cpp
+// Direct execution of MIR procedures
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#include "slang/mir/Interpreter.h"
+
+#include <cstring>
+
+#include "slang/binding/EvalContext.h"
+#include "slang/binding/Expression.h"
+#include "slang/symbols/VariableSymbols.h"
+#include "slang/text/SFormat.h"
+#include "slang/types/AllTypes.h"
+#include "slang/util/Hash.h"
+#include "slang/util/OS.h"
+
+namespace {
+
+using namespace slang;
+
+// Checkpoints start with these magic bytes followed by a version number,
+// the design hash, and then the saved state; see saveCheckpoint().
+constexpr string_view CheckpointMagic = "SLCK"sv;
+constexpr uint8_t CheckpointVersion = 1;
+
+enum class ValueTag : uint8_t { Bad, Integer, UnknownInteger, Real, ShortReal, Null, Unpacked,
+                                String, Queue };
+
+// Values nest once per unpacked dimension or struct level, so real designs never
+// get anywhere close to this; it only guards the reader against hostile input.
+constexpr uint32_t MaxValueDepth = 256;
+
+void appendVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(char(value));
+}
+
+template<typename T>
+void appendRaw(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void appendString(std::string& out, string_view str) {
+    appendVarint(out, str.size());
+    out.append(str);
+}
+
+bool appendValue(std::string& out, const ConstantValue& value) {
+    auto appendElements = [&](const auto& elements) {
+        appendVarint(out, elements.size());
+        for (auto& elem : elements) {
+            if (!appendValue(out, elem))
+                return false;
+        }
+        return true;
+    };
+
+    if (value.isInteger()) {
+        // Two-state values are stored as raw little-endian bytes; values with
+        // unknown bits are rare enough that storing them as literal text is fine.
+        auto& sv = value.integer();
+        if (sv.hasUnknown()) {
+            out.push_back(char(ValueTag::UnknownInteger));
+            appendString(out, sv.toString(LiteralBase::Binary, true));
+        }
+        else {
+            out.push_back(char(ValueTag::Integer));
+            appendVarint(out, sv.getBitWidth());
+            out.push_back(char(sv.isSigned()));
+            out.append(reinterpret_cast<const char*>(sv.getRawPtr()),
+                       (sv.getBitWidth() + 7) / 8);
+        }
+    }
+    else if (value.isReal()) {
+        out.push_back(char(ValueTag::Real));
+        appendRaw(out, double(value.real()));
+    }
+    else if (value.isShortReal()) {
+        out.push_back(char(ValueTag::ShortReal));
+        appendRaw(out, float(value.shortReal()));
+    }
+    else if (value.isNullHandle()) {
+        out.push_back(char(ValueTag::Null));
+    }
+    else if (value.isUnpacked()) {
+        out.push_back(char(ValueTag::Unpacked));
+        return appendElements(value.elements());
+    }
+    else if (value.isString()) {
+        out.push_back(char(ValueTag::String));
+        appendString(out, value.str());
+    }
+    else if (value.isQueue()) {
+        auto& queue = *value.queue();
+        out.push_back(char(ValueTag::Queue));
+        appendVarint(out, queue.maxSize);
+        return appendElements(queue);
+    }
+    else if (value.bad()) {
+        out.push_back(char(ValueTag::Bad));
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+class CheckpointReader {
+public:
+    explicit CheckpointReader(string_view data) : data(data) {}
+
+    bool atEnd() const { return pos == data.size(); }
+
+    bool readBytes(size_t count, string_view& result) {
+        if (data.size() - pos < count)
+            return false;
+
+        result = data.substr(pos, count);
+        pos += count;
+        return true;
+    }
+
+    bool readVarint(uint64_t& result) {
+        result = 0;
+        for (uint32_t shift = 0; shift < 64 && pos < data.size(); shift += 7) {
+            auto byte = uint8_t(data[pos++]);
+            result |= uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    template<typename T>
+    bool readRaw(T& result) {
+        string_view bytes;
+        if (!readBytes(sizeof(T), bytes))
+            return false;
+
+        memcpy(&result, bytes.data(), sizeof(T));
+        return true;
+    }
+
+    bool readString(string_view& result) {
+        uint64_t len;
+        return readVarint(len) && readBytes(len, result);
+    }
+
+    bool readValue(ConstantValue& result, uint32_t depth = 0);
+
+private:
+    template<typename TContainer>
+    bool readElements(TContainer& elements, uint32_t depth) {
+        uint64_t count;
+        if (!readVarint(count) || count > data.size() - pos || depth >= MaxValueDepth)
+            return false;
+
+        for (uint64_t i = 0; i < count; i++) {
+            if (!readValue(elements.emplace_back(), depth + 1))
+                return false;
+        }
+        return true;
+    }
+
+    string_view data;
+    size_t pos = 0;
+};
+
+bool CheckpointReader::readValue(ConstantValue& result, uint32_t depth) {
+    string_view tag;
+    if (!readBytes(1, tag))
+        return false;
+
+    switch (ValueTag(tag[0])) {
+        case ValueTag::Bad:
+            result = nullptr;
+            return true;
+        case ValueTag::Integer: {
+            uint64_t width;
+            string_view isSigned, bytes;
+            if (!readVarint(width) || width == 0 || width > SVInt::MAX_BITS ||
+                !readBytes(1, isSigned) || !readBytes((width + 7) / 8, bytes)) {
+                return false;
+            }
+
+            span<const byte> raw(reinterpret_cast<const byte*>(bytes.data()), bytes.size());
+            result = SVInt(bitwidth_t(width), raw, isSigned[0] != 0);
+            return true;
+        }
+        case ValueTag::UnknownInteger: {
+            string_view text;
+            if (!readString(text))
+                return false;
+
+            try {
+                result = SVInt::fromString(text);
+            }
+            catch (const std::invalid_argument&) {
+                return false;
+            }
+            return true;
+        }
+        case ValueTag::Real: {
+            double d;
+            if (!readRaw(d))
+                return false;
+
+            result = real_t(d);
+            return true;
+        }
+        case ValueTag::ShortReal: {
+            float f;
+            if (!readRaw(f))
+                return false;
+
+            result = shortreal_t(f);
+            return true;
+        }
+        case ValueTag::Null:
+            result = ConstantValue::NullPlaceholder{};
+            return true;
+        case ValueTag::Unpacked: {
+            ConstantValue::Elements elements;
+            if (!readElements(elements, depth))
+                return false;
+
+            result = std::move(elements);
+            return true;
+        }
+        case ValueTag::String: {
+            string_view str;
+            if (!readString(str))
+                return false;
+
+            result = std::string(str);
+            return true;
+        }
+        case ValueTag::Queue: {
+            SVQueue queue;
+            uint64_t maxSize;
+            if (!readVarint(maxSize) || !readElements(queue, depth))
+                return false;
+
+            queue.maxSize = uint32_t(maxSize);
+            result = std::move(queue);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Checks that a restored value has the shape that values of the given type always
+// have, so that nothing downstream sees, say, a real where it expects an integer.
+bool matchesType(const ConstantValue& value, const Type& type) {
+    if (value.bad())
+        return true;
+
+    auto matchesAll = [](const auto& elements, const Type& elementType) {
+        for (auto& elem : elements) {
+            if (!matchesType(elem, elementType))
+                return false;
+        }
+        return true;
+    };
+
+    auto& ct = type.getCanonicalType();
+    switch (ct.kind) {
+        case SymbolKind::FloatingType:
+            if (ct.as<FloatingType>().floatKind == FloatingType::ShortReal)
+                return value.isShortReal();
+            return value.isReal();
+        case SymbolKind::StringType:
+            return value.isString();
+        case SymbolKind::FixedSizeUnpackedArrayType: {
+            auto& fsa = ct.as<FixedSizeUnpackedArrayType>();
+            return value.isUnpacked() && value.elements().size() == fsa.range.width() &&
+                   matchesAll(value.elements(), fsa.elementType);
+        }
+        case SymbolKind::DynamicArrayType:
+            return value.isUnpacked() &&
+                   matchesAll(value.elements(), ct.as<DynamicArrayType>().elementType);
+        case SymbolKind::QueueType: {
+            auto& qt = ct.as<QueueType>();
+            if (!value.isQueue())
+                return false;
+
+            auto& queue = *value.queue();
+            return queue.maxSize == qt.maxSize && (!qt.maxSize || queue.size() <= qt.maxSize) &&
+                   matchesAll(queue, qt.elementType);
+        }
+        case SymbolKind::UnpackedStructType: {
+            if (!value.isUnpacked())
+                return false;
+
+            auto elements = value.elements();
+            size_t index = 0;
+            for (auto& field : ct.as<UnpackedStructType>().membersOfType<FieldSymbol>()) {
+                if (index == elements.size() || !matchesType(elements[index++], field.getType()))
+                    return false;
+            }
+            return index == elements.size();
+        }
+        default:
+            break;
+    }
+
+    if (ct.isIntegral())
+        return value.isInteger() && value.integer().getBitWidth() == ct.getBitWidth();
+
+    // Anything else (handles, events, ...) has no contents worth checking.
+    return value.getVariant().index() == ct.getDefaultValue().getVariant().index();
+}
+
+} // namespace
+
+namespace slang::mir {
+
+Interpreter::Interpreter(const MIRBuilder& builder) : builder(builder) {
+    // Initializers run in declaration order and can refer to globals declared
+    // before them, so each value is made visible to the ones that follow.
+    EvalContext context(builder.compilation, EvalFlags::IsScript);
+    for (auto global : builder.getGlobals()) {
+        ConstantValue value;
+        if (auto init = global->getInitializer())
+            value = init->eval(context);
+
+        if (!value)
+            value = global->getType().getDefaultValue();
+
+        context.createLocal(global, value);
+        globals.emplace_back(std::move(value));
+    }
+}
+
+void Interpreter::run(const Procedure& proc) {
+    executionCounts[&proc]++;
+
+    Frame frame;
+    for (auto local : proc.getLocals())
+        frame.locals.emplace_back(local->getType().getDefaultValue());
+
+    auto instrs = proc.getInstructions();
+    frame.slots.reserve(instrs.size());
+    for (auto& instr : instrs)
+        frame.slots.emplace_back(exec(frame, instr));
+}
+
+uint32_t Interpreter::getExecutionCount(const Procedure& proc) const {
+    auto it = executionCounts.find(&proc);
+    return it == executionCounts.end() ? 0 : it->second;
+}
+
+const ConstantValue& Interpreter::getGlobal(MIRValue val) const {
+    ASSERT(val.getKind() == MIRValue::Global);
+    return globals[val.asIndex()];
+}
+
+bool Interpreter::saveCheckpoint(std::string& result) const {
+    std::string out(CheckpointMagic);
+    out.push_back(char(CheckpointVersion));
+    appendRaw(out, getDesignHash());
+
+    for (auto& value : globals) {
+        if (!appendValue(out, value))
+            return false;
+    }
+
+    for (auto& proc : builder.getInitialProcs())
+        appendVarint(out, getExecutionCount(*proc));
+
+    appendString(out, outputBuffer);
+    result.append(out);
+    return true;
+}
+
+bool Interpreter::restoreCheckpoint(string_view data) {
+    CheckpointReader reader(data);
+    string_view magic, version;
+    uint64_t designHash;
+    if (!reader.readBytes(CheckpointMagic.size(), magic) || magic != CheckpointMagic ||
+        !reader.readBytes(1, version) || uint8_t(version[0]) != CheckpointVersion ||
+        !reader.readRaw(designHash) || designHash != getDesignHash()) {
+        return false;
+    }
+
+    auto globalSymbols = builder.getGlobals();
+    std::vector<ConstantValue> newGlobals(globals.size());
+    for (size_t i = 0; i < newGlobals.size(); i++) {
+        if (!reader.readValue(newGlobals[i]) ||
+            !matchesType(newGlobals[i], globalSymbols[i]->getType())) {
+            return false;
+        }
+    }
+
+    auto procs = builder.getInitialProcs();
+    std::vector<uint64_t> counts(procs.size());
+    for (auto& count : counts) {
+        if (!reader.readVarint(count))
+            return false;
+    }
+
+    string_view output;
+    if (!reader.readString(output) || !reader.atEnd())
+        return false;
+
+    globals = std::move(newGlobals);
+    executionCounts.clear();
+    for (size_t i = 0; i < procs.size(); i++) {
+        if (counts[i])
+            executionCounts[procs[i].get()] = uint32_t(counts[i]);
+    }
+
+    outputBuffer = output;
+    return true;
+}
+
+uint64_t Interpreter::getDesignHash() const {
+    // Checkpoints refer to globals and procedures by index, so they can only
+    // be restored into a design that has the same ones in the same order.
+    std::string buffer;
+    for (auto global : builder.getGlobals()) {
+        global->getHierarchicalPath(buffer);
+        buffer.push_back(':');
+        buffer += global->getType().toString();
+        buffer.push_back('\n');
+    }
+    buffer += std::to_string(builder.getInitialProcs().size());
+
+    return XXH3_64bits(buffer.data(), buffer.size());
+}
+
+ConstantValue Interpreter::eval(const Frame& frame, MIRValue val) const {
+    switch (val.getKind()) {
+        case MIRValue::Constant:
+            return val.asConstant().value;
+        case MIRValue::InstrSlot:
+            return frame.slots[val.asIndex()];
+        case MIRValue::Local:
+            return frame.locals[val.asIndex()];
+        case MIRValue::Global:
+            return globals[val.asIndex()];
+        case MIRValue::Empty:
+            break;
+    }
+    THROW_UNREACHABLE;
+}
+
+ConstantValue& Interpreter::lvalue(Frame& frame, MIRValue val) {
+    switch (val.getKind()) {
+        case MIRValue::Local:
+            return frame.locals[val.asIndex()];
+        case MIRValue::Global:
+            return globals[val.asIndex()];
+        default:
+            THROW_UNREACHABLE;
+    }
+}
+
+ConstantValue Interpreter::exec(Frame& frame, const Instr& instr) {
+    auto ops = instr.getOperands();
+    switch (instr.kind) {
+        case InstrKind::syscall:
+            sysCall(frame, instr);
+            return nullptr;
+        case InstrKind::store:
+            lvalue(frame, ops[0]) = eval(frame, ops[1]);
+            return nullptr;
+        case InstrKind::negate:
+            return -eval(frame, ops[0]).integer();
+        case InstrKind::bitnot:
+            return ~eval(frame, ops[0]).integer();
+        case InstrKind::reducand:
+            return SVInt(eval(frame, ops[0]).integer().reductionAnd());
+        case InstrKind::reducor:
+            return SVInt(eval(frame, ops[0]).integer().reductionOr());
+        case InstrKind::reducxor:
+            return SVInt(eval(frame, ops[0]).integer().reductionXor());
+        case InstrKind::invalid:
+            break;
+    }
+    THROW_UNREACHABLE;
+}
+
+void Interpreter::sysCall(const Frame& frame, const Instr& instr) {
+    auto ops = instr.getOperands();
+    switch (instr.getSysCallKind()) {
+        case SysCallKind::flush:
+            if (eval(frame, ops[0]).isTrue())
+                outputBuffer.push_back('\n');
+
+            if (outputHandler)
+                outputHandler(outputBuffer);
+            else
+                OS::print("{}", outputBuffer);
+            outputBuffer.clear();
+            return;
+        case SysCallKind::printStr:
+            outputBuffer += eval(frame, ops[0]).str();
+            return;
+        case SysCallKind::printInt: {
+            auto value = eval(frame, ops[0]);
+            auto base = LiteralBase(*eval(frame, ops[1]).integer().as<uint8_t>());
+
+            SFormat::FormatOptions options;
+            if (eval(frame, ops[3]).isTrue())
+                options.width = *eval(frame, ops[2]).integer().as<uint32_t>();
+
+            SFormat::formatInt(outputBuffer, value.integer(), base, options);
+            return;
+        }
+        case SysCallKind::printFloat:
+            // The MIR builder does not lower floating point arguments yet.
+            break;
+    }
+    THROW_UNREACHABLE;
+}
+
+} // namespace slang::mir
@@ -16,6 +16,91 @@ namespace slang {
 template<typename T>
 struct always_false : std::false_type {};
 
+SVString::SVString(const std::string& str) : buffer(new Buffer{ str }) {
+}
+
+SVString::SVString(std::string&& str) : buffer(new Buffer{ std::move(str) }) {
+}
+
+SVString::SVString(const SVString& other) noexcept : buffer(other.buffer) {
+    if (buffer)
+        buffer->refCount++;
+}
+
+SVString::SVString(SVString&& other) noexcept : buffer(std::exchange(other.buffer, nullptr)) {
+}
+
+SVString::~SVString() {
+    setBuffer(nullptr);
+}
+
+SVString& SVString::operator=(const SVString& other) noexcept {
+    if (other.buffer)
+        other.buffer->refCount++;
+    setBuffer(other.buffer);
+    return *this;
+}
+
+SVString& SVString::operator=(SVString&& other) noexcept {
+    if (this != &other)
+        setBuffer(std::exchange(other.buffer, nullptr));
+    return *this;
+}
+
+void SVString::setBuffer(Buffer* newBuffer) {
+    if (buffer && --buffer->refCount == 0)
+        delete buffer;
+    buffer = newBuffer;
+}
+
+void SVString::makeUnique(size_t reserve) {
+    if (!buffer) {
+        buffer = new Buffer();
+        buffer->text.reserve(reserve);
+    }
+    else if (buffer->refCount > 1) {
+        auto copy = new Buffer();
+        copy->text.reserve(size() + reserve);
+        copy->text.append(buffer->text);
+        setBuffer(copy);
+    }
+}
+
+std::string& SVString::mutableStr() {
+    makeUnique();
+    return buffer->text;
+}
+
+std::string SVString::release() {
+    std::string result;
+    if (buffer) {
+        if (buffer->refCount == 1)
+            result = std::move(buffer->text);
+        else
+            result = buffer->text;
+        setBuffer(nullptr);
+    }
+    return result;
+}
+
+void SVString::append(string_view text) {
+    if (text.empty())
+        return;
+
+    // If the buffer is shared, the text gets copied out of the old buffer (which
+    // someone else keeps alive) and into our own. Otherwise std::string handles
+    // appending a piece of itself.
+    makeUnique(text.size());
+    buffer->text.append(text.data(), text.size());
+}
+
+void SVString::append(const SVString& other) {
+    if (empty())
+        *this = other;
+    else
+        append(other.view());
+}
+
 const ConstantValue ConstantValue::Invalid;
 
 std::string ConstantValue::toString() const {
@@ -32,21 +117,21 @@ std::string ConstantValue::toString() const {
                 return fmt::format("{}", float(arg));
             else if constexpr (std::is_same_v<T, ConstantValue::NullPlaceholder>)
                 return "null"s;
-            else if constexpr (std::is_same_v<T, Elements>) {
+            else if constexpr (std::is_same_v<T, Unpacked>) {
                 FormatBuffer buffer;
                 buffer.append("[");
-                for (auto& element : arg) {
+                for (auto& element : *arg) {
                     buffer.append(element.toString());
                     buffer.append(",");
                 }
 
-                if (!arg.empty())
+                if (!arg->empty())
                     buffer.pop_back();
                 buffer.append("]");
                 return buffer.str();
             }
-            else if constexpr (std::is_same_v<T, std::string>)
-                return arg;
+            else if constexpr (std::is_same_v<T, SVString>)
+                return std::string(arg.view());
             else if constexpr (std::is_same_v<T, Map>) {
                 FormatBuffer buffer;
                 buffer.append("[");
@@ -95,12 +180,12 @@ size_t ConstantValue::hash() const {
                 hash_combine(h, std::hash<float>()(arg));
             else if constexpr (std::is_same_v<T, ConstantValue::NullPlaceholder>)
                 hash_combine(h, 0);
-            else if constexpr (std::is_same_v<T, Elements>) {
-                for (auto& element : arg)
+            else if constexpr (std::is_same_v<T, Unpacked>) {
+                for (auto& element : *arg)
                     hash_combine(h, element.hash());
             }
-            else if constexpr (std::is_same_v<T, std::string>)
-                hash_combine(h, std::hash<std::string>()(arg));
+            else if constexpr (std::is_same_v<T, SVString>)
+                hash_combine(h, std::hash<string_view>()(arg.view()));
             else if constexpr (std::is_same_v<T, Map>) {
                 for (auto& [key, val] : *arg) {
                     hash_combine(h, key.hash());
@@ -127,8 +212,8 @@ size_t ConstantValue::size() const {
     return std::visit(
         [](auto&& arg) noexcept {
             using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, Elements>)
-                return arg.size();
+            if constexpr (std::is_same_v<T, Unpacked>)
+                return arg->size();
             else if constexpr (std::is_same_v<T, Map>)
                 return arg->size();
             else if constexpr (std::is_same_v<T, Queue>)
@@ -143,8 +228,8 @@ ConstantValue& ConstantValue::at(size_t index) {
     return std::visit(
         [index](auto&& arg) -> ConstantValue& {
             using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, Elements>)
-                return arg.at(index);
+            if constexpr (std::is_same_v<T, Unpacked>)
+                return arg->at(index);
             else if constexpr (std::is_same_v<T, Queue>)
                 return arg->at(index);
             else
@@ -157,8 +242,8 @@ const ConstantValue& ConstantValue::at(size_t index) const {
     return std::visit(
         [index](auto&& arg) -> const ConstantValue& {
             using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, Elements>)
-                return arg.at(index);
+            if constexpr (std::is_same_v<T, Unpacked>)
+                return arg->at(index);
             else if constexpr (std::is_same_v<T, Queue>)
                 return arg->at(index);
             else
@@ -250,8 +335,8 @@ bool ConstantValue::hasUnknown() const {
             if constexpr (std::is_same_v<T, SVInt>) {
                 return arg.hasUnknown();
             }
-            else if constexpr (std::is_same_v<T, Elements>) {
-                for (auto& element : arg) {
+            else if constexpr (std::is_same_v<T, Unpacked>) {
+                for (auto& element : *arg) {
                     if (element.hasUnknown())
                         return true;
                 }
@@ -451,14 +536,14 @@ bool operator==(const ConstantValue& lhs, const ConstantValue& rhs) {
                 return rhs.isShortReal() && arg == float(rhs.shortReal());
             else if constexpr (std::is_same_v<T, ConstantValue::NullPlaceholder>)
                 return rhs.isNullHandle();
-            else if constexpr (std::is_same_v<T, ConstantValue::Elements>) {
+            else if constexpr (std::is_same_v<T, ConstantValue::Unpacked>) {
                 if (!rhs.isUnpacked())
                     return false;
 
-                return arg == std::get<ConstantValue::Elements>(rhs.value);
+                return *arg == *std::get<ConstantValue::Unpacked>(rhs.value);
             }
-            else if constexpr (std::is_same_v<T, std::string>)
-                return rhs.isString() && arg == rhs.str();
+            else if constexpr (std::is_same_v<T, SVString>)
+                return rhs.isString() && arg == rhs.svString();
             else if constexpr (std::is_same_v<T, ConstantValue::Map>) {
                 if (!rhs.isMap())
                     return false;
@@ -492,14 +577,14 @@ bool operator<(const ConstantValue& lhs, const ConstantValue& rhs) {
                 return rhs.isShortReal() && arg < float(rhs.shortReal());
             else if constexpr (std::is_same_v<T, ConstantValue::NullPlaceholder>)
                 return false;
-            else if constexpr (std::is_same_v<T, ConstantValue::Elements>) {
+            else if constexpr (std::is_same_v<T, ConstantValue::Unpacked>) {
                 if (!rhs.isUnpacked())
                     return false;
 
-                return arg < std::get<ConstantValue::Elements>(rhs.value);
+                return *arg < *std::get<ConstantValue::Unpacked>(rhs.value);
             }
-            else if constexpr (std::is_same_v<T, std::string>)
-                return rhs.isString() && arg < rhs.str();
+            else if constexpr (std::is_same_v<T, SVString>)
+                return rhs.isString() && arg < rhs.svString();
             else if constexpr (std::is_same_v<T, ConstantValue::Map>) {
                 if (!rhs.isMap())
                     return false;
@@ -603,11 +688,9 @@ CVIterator begin(ConstantValue& cv) {
     return std::visit(
         [](auto&& arg) -> CVIterator {
             using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, ConstantValue::Elements>) {
-                return arg.begin();
-            }
-            else if constexpr (std::is_same_v<T, ConstantValue::Map> ||
-                               std::is_same_v<T, ConstantValue::Queue>) {
+            if constexpr (std::is_same_v<T, ConstantValue::Unpacked> ||
+                          std::is_same_v<T, ConstantValue::Map> ||
+                          std::is_same_v<T, ConstantValue::Queue>) {
                 return arg->begin();
             }
             else {
@@ -621,11 +704,9 @@ CVIterator end(ConstantValue& cv) {
     return std::visit(
         [](auto&& arg) -> CVIterator {
             using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, ConstantValue::Elements>) {
-                return arg.end();
-            }
-            else if constexpr (std::is_same_v<T, ConstantValue::Map> ||
-                               std::is_same_v<T, ConstantValue::Queue>) {
+            if constexpr (std::is_same_v<T, ConstantValue::Unpacked> ||
+                          std::is_same_v<T, ConstantValue::Map> ||
+                          std::is_same_v<T, ConstantValue::Queue>) {
                 return arg->end();
             }
             else {
@@ -639,11 +720,9 @@ CVConstIterator begin(const ConstantValue& cv) {
     return std::visit(
         [](auto&& arg) -> CVConstIterator {
             using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, ConstantValue::Elements>) {
-                return arg.begin();
-            }
-            else if constexpr (std::is_same_v<T, ConstantValue::Map> ||
-                               std::is_same_v<T, ConstantValue::Queue>) {
+            if constexpr (std::is_same_v<T, ConstantValue::Unpacked> ||
+                          std::is_same_v<T, ConstantValue::Map> ||
+                          std::is_same_v<T, ConstantValue::Queue>) {
                 return arg->begin();
             }
             else {
@@ -657,11 +736,9 @@ CVConstIterator end(const ConstantValue& cv) {
     return std::visit(
         [](auto&& arg) -> CVConstIterator {
             using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, ConstantValue::Elements>) {
-                return arg.end();
-            }
-            else if constexpr (std::is_same_v<T, ConstantValue::Map> ||
-                               std::is_same_v<T, ConstantValue::Queue>) {
+            if constexpr (std::is_same_v<T, ConstantValue::Unpacked> ||
+                          std::is_same_v<T, ConstantValue::Map> ||
+                          std::is_same_v<T, ConstantValue::Queue>) {
                 return arg->end();
             }
             else {
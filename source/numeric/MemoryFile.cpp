@@ -0,0 +1,361 @@
+//------------------------------------------------------------------------------
+// MemoryFile.cpp
+// Loader for $readmemh / $readmemb memory files
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#include "slang/numeric/MemoryFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "slang/util/OS.h"
+#include "slang/util/SmallVector.h"
+
+namespace slang {
+
+namespace {
+
+enum class CharKind : uint8_t { Other, Space, Digit, Unknown, Underscore, Slash, At };
+
+struct CharTable {
+    CharKind kinds[256];
+
+    explicit CharTable(bool isHex) {
+        for (auto& k : kinds)
+            k = CharKind::Other;
+
+        for (char c : " \t\r\n\v\f"sv)
+            kinds[uint8_t(c)] = CharKind::Space;
+
+        if (isHex) {
+            for (char c : "0123456789abcdefABCDEF"sv)
+                kinds[uint8_t(c)] = CharKind::Digit;
+        }
+        else {
+            kinds[uint8_t('0')] = CharKind::Digit;
+            kinds[uint8_t('1')] = CharKind::Digit;
+        }
+
+        for (char c : "xXzZ"sv)
+            kinds[uint8_t(c)] = CharKind::Unknown;
+
+        kinds[uint8_t('_')] = CharKind::Underscore;
+        kinds[uint8_t('/')] = CharKind::Slash;
+        kinds[uint8_t('@')] = CharKind::At;
+    }
+
+    CharKind operator[](char c) const { return kinds[uint8_t(c)]; }
+};
+
+const CharTable hexTable(true);
+const CharTable binTable(false);
+
+uint64_t load64(const char* ptr) {
+    uint64_t v;
+    memcpy(&v, ptr, sizeof(v));
+    return v;
+}
+
+uint32_t hexDigitValue(char c) {
+    return uint32_t(c & 0xf) + 9 * uint32_t((c >> 6) & 1);
+}
+
+// Converts eight ASCII hex digits (most significant first) into a 32-bit value
+// using SWAR arithmetic on a single 64-bit load.
+uint32_t parseHex8(const char* ptr) {
+    uint64_t v = load64(ptr);
+    v = (v & 0x0F0F0F0F0F0F0F0F) + 9 * ((v >> 6) & 0x0101010101010101);
+    v = ((v << 4) | (v >> 8)) & 0x00FF00FF00FF00FF;
+    v = ((v << 8) | (v >> 16)) & 0x0000FFFF0000FFFF;
+    return uint32_t((v << 16) | (v >> 32));
+}
+
+// Converts eight ASCII binary digits (most significant first) into an 8-bit value.
+// The multiply gathers the low bit of each byte into the top byte of the product.
+uint32_t parseBin8(const char* ptr) {
+    uint64_t v = load64(ptr) & 0x0101010101010101;
+    return uint32_t((v * 0x8040201008040201) >> 56);
+}
+
+class MemoryFileParser {
+public:
+    MemoryFileParser(string_view text, const MemoryFile::Options& options,
+                     MemoryFile::WordCallback callback) :
+        table(options.isHex ? hexTable : binTable),
+        options(options), callback(callback), ptr(text.data()), begin(text.data()),
+        end(text.data() + text.size()) {
+
+        numLimbs = (options.wordWidth + 63) / 64;
+        limbs.resize(numLimbs);
+
+        decreasing = options.start && options.finish && *options.finish < *options.start;
+        address = options.start.value_or(options.lowAddress);
+        if (options.finish) {
+            regionLow = std::min(address, *options.finish);
+            regionHigh = std::max(address, *options.finish);
+        }
+        else {
+            regionLow = address;
+            regionHigh = options.highAddress;
+        }
+    }
+
+    MemoryFile::Result parse() {
+        // Every word lands between the start and finish addresses, so checking
+        // both ends up front keeps all callbacks inside the memory.
+        if (!inMemory(address) || (options.finish && !inMemory(*options.finish)))
+            return error(MemoryFile::Error::AddressOutOfRange);
+
+        while (ptr != end) {
+            switch (table[*ptr]) {
+                case CharKind::Space:
+                    ptr++;
+                    break;
+                case CharKind::Slash:
+                    if (!skipComment())
+                        return error(MemoryFile::Error::InvalidDigit);
+                    break;
+                case CharKind::At:
+                    if (!parseAddress())
+                        return result;
+                    break;
+                case CharKind::Digit:
+                case CharKind::Unknown:
+                case CharKind::Underscore:
+                    // Words beyond the finish address are ignored.
+                    if (exhausted)
+                        return result;
+                    parseWord();
+                    break;
+                case CharKind::Other:
+                    return error(MemoryFile::Error::InvalidDigit);
+            }
+        }
+
+        return result;
+    }
+
+private:
+    const CharTable& table;
+    const MemoryFile::Options& options;
+    MemoryFile::WordCallback callback;
+    const char* ptr;
+    const char* begin;
+    const char* end;
+
+    MemoryFile::Result result;
+    SmallVectorSized<uint64_t, 4> limbs;
+    SmallVectorSized<logic_t, 64> digits;
+    uint32_t numLimbs;
+
+    uint64_t address;
+    uint64_t regionLow;
+    uint64_t regionHigh;
+    bool decreasing;
+    bool exhausted = false;
+
+    bool inMemory(uint64_t addr) const {
+        return addr >= options.lowAddress && addr <= options.highAddress;
+    }
+
+    MemoryFile::Result& error(MemoryFile::Error code) {
+        result.error = code;
+        result.line = size_t(std::count(begin, ptr, '\n')) + 1;
+        return result;
+    }
+
+    bool skipComment() {
+        if (ptr + 1 == end)
+            return false;
+
+        if (ptr[1] == '/') {
+            auto nl = static_cast<const char*>(memchr(ptr, '\n', size_t(end - ptr)));
+            ptr = nl ? nl : end;
+            return true;
+        }
+
+        if (ptr[1] == '*') {
+            for (ptr += 2; ptr + 1 < end; ptr++) {
+                if (ptr[0] == '*' && ptr[1] == '/') {
+                    ptr += 2;
+                    return true;
+                }
+            }
+            ptr = end;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool parseAddress() {
+        ptr++;
+        uint64_t addr = 0;
+        bool any = false;
+        for (; ptr != end; ptr++) {
+            char c = *ptr;
+            if (c == '_')
+                continue;
+            if (hexTable[c] != CharKind::Digit)
+                break;
+
+            addr = (addr << 4) | hexDigitValue(c);
+            any = true;
+        }
+
+        if (!any || (ptr != end && table[*ptr] != CharKind::Space &&
+                     table[*ptr] != CharKind::Slash)) {
+            error(MemoryFile::Error::InvalidAddress);
+            return false;
+        }
+
+        if (!inMemory(addr) || addr < regionLow || addr > regionHigh) {
+            error(MemoryFile::Error::AddressOutOfRange);
+            return false;
+        }
+
+        address = addr;
+        exhausted = false;
+        return true;
+    }
+
+    void parseWord() {
+        // Find the extent of the word, noting whether it contains
+        // anything other than plain digits.
+        const char* start = ptr;
+        bool simple = true;
+        for (; ptr != end; ptr++) {
+            CharKind kind = table[*ptr];
+            if (kind == CharKind::Digit)
+                continue;
+            if (kind != CharKind::Unknown && kind != CharKind::Underscore)
+                break;
+            simple = false;
+        }
+
+        if (simple)
+            callback(address, parseSimple(start, ptr));
+        else
+            callback(address, parseComplex(start, ptr));
+
+        result.wordsLoaded++;
+        if (decreasing) {
+            if (address == regionLow)
+                exhausted = true;
+            else
+                address--;
+        }
+        else {
+            if (address == regionHigh)
+                exhausted = true;
+            else
+                address++;
+        }
+    }
+
+    // Parses a word made up only of known digits. Digits are consumed from the least
+    // significant end in chunks of eight, so each chunk lands on a fixed bit offset.
+    SVInt parseSimple(const char* first, const char* last) {
+        std::fill(limbs.begin(), limbs.end(), 0);
+
+        const uint32_t digitBits = options.isHex ? 4 : 1;
+        const uint32_t chunkBits = digitBits * 8;
+        const uint32_t maxBits = numLimbs * 64;
+
+        uint32_t bitPos = 0;
+        while (last - first >= 8 && bitPos < maxBits) {
+            last -= 8;
+            uint64_t chunk = options.isHex ? parseHex8(last) : parseBin8(last);
+            limbs[bitPos / 64] |= chunk << (bitPos % 64);
+            bitPos += chunkBits;
+        }
+
+        while (last != first && bitPos < maxBits) {
+            last--;
+            uint64_t digit = options.isHex ? hexDigitValue(*last) : uint64_t(*last - '0');
+            limbs[bitPos / 64] |= digit << (bitPos % 64);
+            bitPos += digitBits;
+        }
+
+        if (numLimbs == 1)
+            return SVInt(options.wordWidth, limbs[0], false);
+
+        return SVInt(options.wordWidth,
+                     span<const byte>(reinterpret_cast<const byte*>(limbs.data()),
+                                      numLimbs * sizeof(uint64_t)),
+                     false);
+    }
+
+    // Parses a word that contains unknown digits or underscores.
+    SVInt parseComplex(const char* first, const char* last) {
+        digits.clear();
+        bool anyUnknown = false;
+        for (; first != last; first++) {
+            char c = *first;
+            switch (c) {
+                case '_':
+                    break;
+                case 'x':
+                case 'X':
+                    digits.append(logic_t::x);
+                    anyUnknown = true;
+                    break;
+                case 'z':
+                case 'Z':
+                    digits.append(logic_t::z);
+                    anyUnknown = true;
+                    break;
+                default:
+                    digits.append(logic_t(uint8_t(options.isHex ? hexDigitValue(c) : c - '0')));
+                    break;
+            }
+        }
+
+        if (digits.empty())
+            digits.append(logic_t(0));
+
+        return SVInt::fromDigits(options.wordWidth,
+                                 options.isHex ? LiteralBase::Hex : LiteralBase::Binary, false,
+                                 anyUnknown, digits);
+    }
+};
+
+} // namespace
+
+MemoryFile::Result MemoryFile::load(const std::string& path, const Options& options,
+                                    WordCallback callback) {
+    MappedFile file;
+    if (!file.open(path)) {
+        Result result;
+        result.error = Error::OpenFailed;
+        return result;
+    }
+
+    return parse(file.text(), options, callback);
+}
+
+MemoryFile::Result MemoryFile::parse(string_view text, const Options& options,
+                                     WordCallback callback) {
+    ASSERT(options.wordWidth);
+    ASSERT(options.lowAddress <= options.highAddress);
+    return MemoryFileParser(text, options, callback).parse();
+}
+
+string_view MemoryFile::errorToString(Error error) {
+    switch (error) {
+        case Error::None:
+            return "no error"sv;
+        case Error::OpenFailed:
+            return "file could not be opened"sv;
+        case Error::InvalidDigit:
+            return "invalid character in memory file"sv;
+        case Error::InvalidAddress:
+            return "invalid address specification"sv;
+        case Error::AddressOutOfRange:
+            return "address is outside of the memory range"sv;
+    }
+    THROW_UNREACHABLE;
+}
+
+} // namespace slang
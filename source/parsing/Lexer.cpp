@@ -9,6 +9,7 @@
 #include "../text/CharInfo.h"
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 #include "slang/diagnostics/LexerDiags.h"
 #include "slang/diagnostics/NumericDiags.h"
@@ -171,6 +172,45 @@ Token Lexer::lex(KeywordVersion keywordVersion) {
     return token;
 }
 
+// Finds the next character that could start a directive, string literal, comment,
+// escaped identifier, or line continuation. Checks eight bytes at a time with the
+// usual "has zero byte" trick; the buffer is null terminated so this always stops.
+static const char* findDirectiveStart(const char* ptr, const char* end) {
+    constexpr uint64_t ones = 0x0101010101010101;
+    constexpr uint64_t highs = 0x8080808080808080;
+    auto hasByte = [](uint64_t v, uint8_t b) {
+        uint64_t x = v ^ (ones * b);
+        return (x - ones) & ~x & highs;
+    };
+
+    while (end - ptr >= 8) {
+        uint64_t v;
+        memcpy(&v, ptr, sizeof(v));
+        if (hasByte(v, '`') | hasByte(v, '"') | hasByte(v, '/') | hasByte(v, '\\') |
+            hasByte(v, 0)) {
+            break;
+        }
+        ptr += 8;
+    }
+
+    while (*ptr != '`' && *ptr != '"' && *ptr != '/' && *ptr != '\\' && *ptr != '\0')
+        ptr++;
+    return ptr;
+}
+
+bool Lexer::skipToDirective() {
+    const char* start = sourceBuffer;
+    const char* last = findDirectiveStart(start, sourceEnd);
+    while (last != start && isWhitespace(last[-1]))
+        last--;
+
+    if (last == start)
+        return false;
+
+    sourceBuffer = last;
+    return true;
+}
+
 Token Lexer::lexToken(KeywordVersion keywordVersion) {
     char c = peek();
     advance();
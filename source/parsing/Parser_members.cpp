@@ -22,6 +22,9 @@ CompilationUnitSyntax& Parser::parseCompilationUnit() {
     catch (const RecursionException&) {
         return factory.compilationUnit(nullptr, eofToken);
     }
+    catch (const CancelledException&) {
+        return factory.compilationUnit(nullptr, eofToken);
+    }
 }
 
 ModuleDeclarationSyntax& Parser::parseModule() {
@@ -323,6 +326,9 @@ span<TMember*> Parser::parseMemberList(TokenKind endKind, Token& endToken, Synta
         if (kind == TokenKind::EndOfFile || kind == endKind)
             break;
 
+        if (parseOptions.cancellation.isCancelled())
+            throw CancelledException("");
+
         auto member = parseFunc(parentKind, anyLocalModules);
         if (member) {
             checkMemberAllowed(*member, parentKind);
@@ -37,20 +37,27 @@ Preprocessor::Preprocessor(const Preprocessor& other) :
 
 void Preprocessor::pushSource(string_view source, string_view name) {
     auto buffer = sourceManager.assignText(name, source);
+    createdBuffers.push_back(buffer.id);
     pushSource(buffer);
 }
 
 void Preprocessor::pushSource(SourceBuffer buffer) {
     ASSERT(buffer.id);
 
+    if (options.prefetchIncludes)
+        sourceManager.prefetchIncludes(buffer);
+
     lexerStack.emplace_back(std::make_unique<Lexer>(buffer, alloc, diagnostics, lexerOptions));
 }
 
 void Preprocessor::predefine(const std::string& definition, string_view fileName) {
     std::string text = "`define " + definition + "\n";
 
+    auto buffer = sourceManager.assignText(fileName, string_view(text));
+    createdBuffers.push_back(buffer.id);
+
     Preprocessor pp(*this);
-    pp.pushSource(sourceManager.assignText(fileName, string_view(text)));
+    pp.pushSource(buffer);
 
     // Consume all of the definition text.
     while (pp.next().kind != TokenKind::EndOfFile) {
@@ -120,6 +127,34 @@ void Preprocessor::resetAllDirectives() {
     unconnectedDrive = TokenKind::Unknown;
 }
 
+void Preprocessor::copyStateFrom(const Preprocessor& other) {
+    macros = other.macros;
+    includeOnceHeaders = other.includeOnceHeaders;
+    keywordVersionStack = other.keywordVersionStack;
+    activeTimeScale = other.activeTimeScale;
+    defaultNetType = other.defaultNetType;
+    unconnectedDrive = other.unconnectedDrive;
+}
+
+void Preprocessor::setSplitSource(optional<span<const Trivia>> preceding, bool isLast) {
+    precedingTrivia = preceding;
+    continuesInNextSource = !isLast;
+}
+
+void Preprocessor::setRegisteredBuffers(span<const SourceBuffer> buffers) {
+    registeredBuffers.clear();
+    for (auto& buffer : buffers)
+        registeredBuffers.insert(buffer.id);
+}
+
+bool Preprocessor::shouldRegisterDirective(SourceLocation location) const {
+    if (registeredBuffers.empty())
+        return true;
+
+    auto buffer = sourceManager.getFullyExpandedLoc(location).buffer();
+    return registeredBuffers.find(buffer) == registeredBuffers.end();
+}
+
 std::vector<const DefineDirectiveSyntax*> Preprocessor::getDefinedMacros() const {
     std::vector<const DefineDirectiveSyntax*> results;
     for (auto& [name, def] : macros) {
@@ -131,6 +166,14 @@ std::vector<const DefineDirectiveSyntax*> Preprocessor::getDefinedMacros() const
 }
 
 Token Preprocessor::next() {
+    // In directive-only mode, skip ahead in the current file when there's nothing
+    // buffered. Any trivia carried over from a previous source would have been
+    // attached to the first skipped token, so it gets dropped along with it.
+    if (directivesOnly && !currentToken && !currentMacroToken && !inMacroBody &&
+        !lexerStack.empty() && lexerStack.back()->skipToDirective()) {
+        precedingTrivia.reset();
+    }
+
     return consume();
 }
 
@@ -279,14 +322,22 @@ Token Preprocessor::nextRaw() {
     // This is the common case.
     auto& source = lexerStack.back();
     auto token = source->lex(keywordVersionStack.back());
-    if (token.kind != TokenKind::EndOfFile)
+    if (token.kind != TokenKind::EndOfFile) {
+        if (precedingTrivia)
+            return mergePrecedingTrivia(token);
         return token;
+    }
 
     // don't return EndOfFile tokens for included files, fall
     // through to loop to merge trivia
     lexerStack.pop_back();
-    if (lexerStack.empty())
+    if (lexerStack.empty()) {
+        // If this is one piece of a split compilation unit, the trivia here
+        // would have been merged onto the first token of the next file.
+        if (precedingTrivia || continuesInNextSource)
+            return mergePrecedingTrivia(token);
         return token;
+    }
 
     // Rare case: we have an EoF from an include file... we don't want to return
     // that one, but we do want to merge its trivia with whatever comes next.
@@ -315,6 +366,21 @@ Token Preprocessor::nextRaw() {
     return token.withTrivia(alloc, trivia.copy(alloc));
 }
 
+Token Preprocessor::mergePrecedingTrivia(Token token) {
+    // This matches the way trivia gets merged across source boundaries in nextRaw().
+    SmallVectorSized<Trivia, 16> trivia;
+    if (precedingTrivia) {
+        trivia.appendRange(*precedingTrivia);
+        precedingTrivia.reset();
+    }
+
+    SourceLocation loc = token.location();
+    for (const auto& t : token.trivia())
+        trivia.append(t.withLocation(alloc, loc));
+
+    return token.withTrivia(alloc, trivia.copy(alloc));
+}
+
 Trivia Preprocessor::handleIncludeDirective(Token directive) {
     // A (valid) macro-expanded include filename will be lexed as either
     // a StringLiteral or the token sequence '<' ... '>'
@@ -720,7 +786,7 @@ Trivia Preprocessor::handleLineDirective(Token directive) {
             // only the values 0,1,2
             addDiag(diag::InvalidLineDirectiveLevel, level.range());
         }
-        else if (lineNum) {
+        else if (lineNum && shouldRegisterDirective(directive.location())) {
             // We should only notify the source manager about the line directive if it
             // is well formed, to avoid very strange line number issues.
             sourceManager.addLineDirective(directive.location(), *lineNum, fileName.valueText(),
@@ -1092,17 +1158,22 @@ void Preprocessor::applyDiagnosticPragma(const PragmaDirectiveSyntax& pragma) {
         return;
     }
 
+    const bool shouldRegister = shouldRegisterDirective(pragma.directive.location());
+    auto addDirective = [&](SourceLocation location, string_view name,
+                            DiagnosticSeverity severity) {
+        if (shouldRegister)
+            sourceManager.addDiagnosticDirective(location, name, severity);
+    };
+
     for (auto arg : pragma.args) {
         if (arg->kind == SyntaxKind::SimplePragmaExpression) {
             auto& simple = arg->as<SimplePragmaExpressionSyntax>();
             string_view action = simple.value.rawText();
             if (simple.value.kind == TokenKind::Identifier && action == "push") {
-                sourceManager.addDiagnosticDirective(simple.value.location(), "__push__",
-                                                     DiagnosticSeverity::Ignored);
+                addDirective(simple.value.location(), "__push__", DiagnosticSeverity::Ignored);
             }
             else if (simple.value.kind == TokenKind::Identifier && action == "pop") {
-                sourceManager.addDiagnosticDirective(simple.value.location(), "__pop__",
-                                                     DiagnosticSeverity::Ignored);
+                addDirective(simple.value.location(), "__pop__", DiagnosticSeverity::Ignored);
             }
             else {
                 addDiag(diag::UnknownDiagPragmaArg, simple.value.range()) << action;
@@ -1130,8 +1201,8 @@ void Preprocessor::applyDiagnosticPragma(const PragmaDirectiveSyntax& pragma) {
                 if (expr.kind == SyntaxKind::SimplePragmaExpression) {
                     auto& simple = expr.as<SimplePragmaExpressionSyntax>();
                     if (simple.value.kind == TokenKind::StringLiteral) {
-                        sourceManager.addDiagnosticDirective(simple.value.location(),
-                                                             simple.value.valueText(), severity);
+                        addDirective(simple.value.location(), simple.value.valueText(),
+                                     severity);
                     }
                     else {
                         addDiag(diag::ExpectedDiagPragmaArg, simple.value.range());
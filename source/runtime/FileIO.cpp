@@ -0,0 +1,1082 @@
+//------------------------------------------------------------------------------
+// FileIO.cpp
+// Simulation file I/O routines
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#include "slang/runtime/FileIO.h"
+
+#include "Storage.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "slang/numeric/SVInt.h"
+#include "slang/runtime/Runtime.h"
+#include "slang/util/SmallVector.h"
+
+namespace {
+
+// Plain fseek / ftell use a long for the offset, which is only 32 bits on
+// LLP64 platforms and would truncate positions past 2 GiB.
+int seekFile(FILE* file, int64_t offset, int origin) {
+#if defined(_MSC_VER)
+    return _fseeki64(file, offset, origin);
+#else
+    return fseeko(file, off_t(offset), origin);
+#endif
+}
+
+int64_t tellFile(FILE* file) {
+#if defined(_MSC_VER)
+    return _ftelli64(file);
+#else
+    return int64_t(ftello(file));
+#endif
+}
+
+} // namespace
+
+namespace slang::runtime {
+
+BufferedFile::BufferedFile(FILE* file, bool owned) :
+    file(file), owned(owned), buffer(new char[BufferSize]) {
+
+    // All buffering happens here, so don't let the C library copy everything twice.
+    if (owned)
+        setvbuf(file, nullptr, _IONBF, 0);
+
+    int64_t start = tellFile(file);
+    filePos = start < 0 ? 0 : start;
+    pos = end = PushbackSlack;
+}
+
+BufferedFile::~BufferedFile() {
+    flush();
+    if (owned)
+        fclose(file);
+}
+
+int BufferedFile::getc() {
+    int c = peek();
+    if (c != EOF)
+        pos++;
+    return c;
+}
+
+int BufferedFile::peek() {
+    if (pos == end && (!beginRead() || !refill(1)))
+        return EOF;
+    return (unsigned char)buffer[pos];
+}
+
+bool BufferedFile::ungetc(int c) {
+    if (c == EOF || !beginRead() || pos == 0)
+        return false;
+
+    buffer[--pos] = char(c);
+    return true;
+}
+
+std::string_view BufferedFile::window(size_t count) {
+    if (!beginRead())
+        return {};
+
+    refill(count);
+    return std::string_view(buffer.get() + pos, end - pos);
+}
+
+size_t BufferedFile::read(char* dest, size_t count) {
+    if (!beginRead())
+        return 0;
+
+    size_t total = std::min(count, end - pos);
+    memcpy(dest, buffer.get() + pos, total);
+    pos += total;
+
+    // Large reads bypass the buffer and go straight into the destination.
+    while (total < count && !atEnd) {
+        size_t remaining = count - total;
+        if (remaining >= BufferSize / 2) {
+            size_t got = fread(dest + total, 1, remaining, file);
+            filePos += int64_t(got);
+            total += got;
+            if (got < remaining) {
+                atEnd = true;
+                if (ferror(file))
+                    lastError = errno;
+            }
+        }
+        else {
+            refill(remaining);
+            size_t got = std::min(remaining, end - pos);
+            memcpy(dest + total, buffer.get() + pos, got);
+            pos += got;
+            total += got;
+            if (got == 0)
+                break;
+        }
+    }
+
+    return total;
+}
+
+bool BufferedFile::write(std::string_view text) {
+    if (!beginWrite())
+        return false;
+
+    if (text.size() > BufferSize - end) {
+        if (!flush())
+            return false;
+
+        if (text.size() >= BufferSize) {
+            size_t written = fwrite(text.data(), 1, text.size(), file);
+            filePos += int64_t(written);
+            if (written != text.size()) {
+                lastError = errno;
+                return false;
+            }
+            return true;
+        }
+    }
+
+    memcpy(buffer.get() + end, text.data(), text.size());
+    end += text.size();
+    return true;
+}
+
+bool BufferedFile::flush() {
+    if (!writing)
+        return true;
+
+    size_t written = end ? fwrite(buffer.get(), 1, end, file) : 0;
+    filePos += int64_t(written);
+    bool ok = written == end;
+    end = 0;
+
+    if (fflush(file) != 0)
+        ok = false;
+
+    if (!ok)
+        lastError = errno;
+    return ok;
+}
+
+bool BufferedFile::seek(int64_t offset, int origin) {
+    if (origin == SEEK_CUR) {
+        offset += tell();
+        origin = SEEK_SET;
+    }
+
+    flush();
+    writing = false;
+    atEnd = false;
+    pos = end = PushbackSlack;
+
+    if (seekFile(file, offset, origin) != 0) {
+        lastError = errno;
+        return false;
+    }
+
+    int64_t newPos = tellFile(file);
+    filePos = newPos < 0 ? 0 : newPos;
+    return true;
+}
+
+int64_t BufferedFile::tell() const {
+    if (writing)
+        return filePos + int64_t(end);
+    return filePos - int64_t(end - pos);
+}
+
+int BufferedFile::takeError() {
+    int result = lastError;
+    lastError = 0;
+    return result;
+}
+
+bool BufferedFile::beginRead() {
+    if (!writing)
+        return true;
+
+    if (!flush())
+        return false;
+
+    writing = false;
+    pos = end = PushbackSlack;
+    return true;
+}
+
+bool BufferedFile::beginWrite() {
+    if (writing)
+        return true;
+
+    // Any read-ahead data has to be discarded, and the underlying
+    // file repositioned to where the reader logically is.
+    if (pos != end) {
+        int64_t logical = tell();
+        if (seekFile(file, logical, SEEK_SET) != 0) {
+            lastError = errno;
+            return false;
+        }
+        filePos = logical;
+    }
+
+    writing = true;
+    atEnd = false;
+    pos = end = 0;
+    return true;
+}
+
+bool BufferedFile::refill(size_t count) {
+    count = std::min(count, BufferSize - PushbackSlack);
+    if (end - pos >= count)
+        return true;
+
+    if (atEnd)
+        return end != pos;
+
+    if (pos + count > BufferSize) {
+        size_t avail = end - pos;
+        memmove(buffer.get() + PushbackSlack, buffer.get() + pos, avail);
+        pos = PushbackSlack;
+        end = pos + avail;
+    }
+
+    while (end - pos < count) {
+        size_t got = fread(buffer.get() + end, 1, BufferSize - end, file);
+        filePos += int64_t(got);
+        end += got;
+        if (got == 0) {
+            atEnd = true;
+            if (ferror(file)) {
+                lastError = errno;
+                clearerr(file);
+            }
+            break;
+        }
+    }
+
+    return end != pos;
+}
+
+FileTable::FileTable() {
+    files.emplace_back(std::make_unique<BufferedFile>(stdin, false));
+    files.emplace_back(nullptr);
+    files.emplace_back(std::make_unique<BufferedFile>(stderr, false));
+}
+
+FileTable& FileTable::instance() {
+    static FileTable table;
+    return table;
+}
+
+uint32_t FileTable::open(std::string_view path, std::string_view mode) {
+    bool isMcd = mode.empty();
+    if (isMcd)
+        mode = "w";
+
+    static constexpr std::string_view validModes[] = { "r",   "rb",  "w",   "wb",  "a",   "ab",
+                                                       "r+",  "r+b", "rb+", "w+",  "w+b", "wb+",
+                                                       "a+",  "a+b", "ab+" };
+    if (std::find(std::begin(validModes), std::end(validModes), mode) == std::end(validModes)) {
+        openError = EINVAL;
+        return 0;
+    }
+
+    FILE* file = fopen(std::string(path).c_str(), std::string(mode).c_str());
+    if (!file) {
+        openError = errno;
+        return 0;
+    }
+
+    auto entry = std::make_unique<BufferedFile>(file, true);
+    if (isMcd) {
+        for (uint32_t i = 1; i <= MaxChannels; i++) {
+            if (!channels[i]) {
+                channels[i] = std::move(entry);
+                return 1u << i;
+            }
+        }
+
+        openError = EMFILE;
+        return 0;
+    }
+
+    for (size_t i = 3; i < files.size(); i++) {
+        if (!files[i]) {
+            files[i] = std::move(entry);
+            return FdFlag | uint32_t(i);
+        }
+    }
+
+    files.emplace_back(std::move(entry));
+    return FdFlag | uint32_t(files.size() - 1);
+}
+
+void FileTable::close(uint32_t fd) {
+    if (fd & FdFlag) {
+        uint32_t index = fd & ~FdFlag;
+        if (index >= 3 && index < files.size())
+            files[index].reset();
+        return;
+    }
+
+    for (uint32_t i = 1; i <= MaxChannels; i++) {
+        if (fd & (1u << i))
+            channels[i].reset();
+    }
+}
+
+BufferedFile* FileTable::get(uint32_t fd) {
+    if (!(fd & FdFlag))
+        return nullptr;
+
+    uint32_t index = fd & ~FdFlag;
+    return index < files.size() ? files[index].get() : nullptr;
+}
+
+bool FileTable::includesStdout(uint32_t fd) {
+    return fd == Stdout || (!(fd & FdFlag) && (fd & 1));
+}
+
+void FileTable::write(uint32_t fd, std::string_view text) {
+    if (fd & FdFlag) {
+        if (auto file = get(fd)) {
+            file->write(text);
+            if (fd == Stderr)
+                file->flush();
+        }
+        return;
+    }
+
+    for (uint32_t i = 1; i <= MaxChannels; i++) {
+        if ((fd & (1u << i)) && channels[i])
+            channels[i]->write(text);
+    }
+}
+
+void FileTable::flush(uint32_t fd) {
+    if (fd == 0) {
+        for (auto& file : files) {
+            if (file)
+                file->flush();
+        }
+        for (auto& file : channels) {
+            if (file)
+                file->flush();
+        }
+        return;
+    }
+
+    if (fd & FdFlag) {
+        if (auto file = get(fd))
+            file->flush();
+        return;
+    }
+
+    for (uint32_t i = 1; i <= MaxChannels; i++) {
+        if ((fd & (1u << i)) && channels[i])
+            channels[i]->flush();
+    }
+}
+
+int FileTable::takeOpenError() {
+    int result = openError;
+    openError = 0;
+    return result;
+}
+
+} // namespace slang::runtime
+
+using namespace slang;
+using namespace slang::runtime;
+
+namespace {
+
+// Storage for strings produced by $fscanf, reused across calls so that
+// steady-state scanning doesn't allocate.
+std::vector<std::string> scanStrings;
+
+// Clears the storage for an integral destination.
+uint64_t* clearStorage(uint64_t* dest, uint32_t width, bool isFourState) {
+    std::fill(dest, dest + getStorageWords(width, isFourState), 0);
+    return dest;
+}
+
+void storeInt(const ScanArg& arg, const SVInt& value) {
+    switch (arg.kind) {
+        case ScanArgKind::Real:
+            *static_cast<double*>(arg.data) = value.toDouble();
+            return;
+        case ScanArgKind::ShortReal:
+            *static_cast<float*>(arg.data) = value.toFloat();
+            return;
+        case ScanArgKind::String:
+            return;
+        default:
+            break;
+    }
+
+    storeValue(static_cast<uint64_t*>(arg.data), arg.width, arg.kind == ScanArgKind::FourState,
+               value.resize(arg.width));
+}
+
+void storeInt(const ScanArg& arg, uint64_t value) {
+    if (arg.kind == ScanArgKind::Real || arg.kind == ScanArgKind::ShortReal ||
+        arg.kind == ScanArgKind::String || arg.width > 64) {
+        storeInt(arg, SVInt(64, value, false));
+        return;
+    }
+
+    uint64_t* dest = clearStorage(static_cast<uint64_t*>(arg.data), arg.width,
+                                  arg.kind == ScanArgKind::FourState);
+    if (arg.width < 64)
+        value &= (1ull << arg.width) - 1;
+    dest[0] = value;
+}
+
+void storeReal(const ScanArg& arg, double value) {
+    switch (arg.kind) {
+        case ScanArgKind::Real:
+            *static_cast<double*>(arg.data) = value;
+            break;
+        case ScanArgKind::ShortReal:
+            *static_cast<float*>(arg.data) = float(value);
+            break;
+        case ScanArgKind::String:
+            break;
+        default:
+            storeInt(arg, SVInt::fromDouble(arg.width, value, true));
+            break;
+    }
+}
+
+// Stores characters into an integral destination, with the last
+// character in the least significant byte.
+void storeChars(const ScanArg& arg, std::string_view text) {
+    if (arg.kind != ScanArgKind::TwoState && arg.kind != ScanArgKind::FourState)
+        return;
+
+    auto dest = clearStorage(static_cast<uint64_t*>(arg.data), arg.width,
+                             arg.kind == ScanArgKind::FourState);
+    uint32_t maxChars = arg.width / 8;
+    if (text.size() > maxChars)
+        text = text.substr(text.size() - maxChars);
+
+    uint32_t bit = 0;
+    for (size_t i = text.size(); i > 0; i--, bit += 8) {
+        uint64_t c = (unsigned char)text[i - 1];
+        dest[bit / 64] |= c << (bit % 64);
+    }
+}
+
+// Converts big-endian bytes (as read by $fread) into an integral value. The last
+// byte lands in the least significant position, so a short read at the end of
+// the file fills the value from the bottom up at any width.
+void storeBigEndian(uint64_t* dest, uint32_t width, bool isFourState, const char* bytes,
+                    size_t count) {
+    clearStorage(dest, width, isFourState);
+
+    uint32_t bit = 0;
+    for (size_t i = count; i > 0 && bit < width; i--, bit += 8) {
+        uint64_t b = (unsigned char)bytes[i - 1];
+        if (width - bit < 8)
+            b &= (1ull << (width - bit)) - 1;
+        dest[bit / 64] |= b << (bit % 64);
+    }
+}
+
+struct FileSource {
+    static constexpr bool StableTokens = false;
+
+    BufferedFile& file;
+
+    int peek() { return file.peek(); }
+    std::string_view window(size_t count) { return file.window(count); }
+    void consume(size_t count) { file.consume(count); }
+};
+
+struct StringSource {
+    static constexpr bool StableTokens = true;
+
+    std::string_view text;
+
+    int peek() { return text.empty() ? EOF : (unsigned char)text[0]; }
+    std::string_view window(size_t) { return text; }
+    void consume(size_t count) { text.remove_prefix(count); }
+};
+
+bool isSpace(int c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+bool isUnknownDigit(char c) {
+    return c == 'x' || c == 'X' || c == 'z' || c == 'Z' || c == '?';
+}
+
+// Implements the $fscanf / $sscanf format conversions (IEEE 1800-2017 21.3.4.3).
+// Tokens are matched directly against the source's buffered data; only string
+// results from files are copied out, since the buffer may be refilled before
+// the caller sees them.
+template<typename Source>
+class Scanner {
+public:
+    Scanner(Source& source, ScanArg* args, uint32_t numArgs, std::string_view scope) :
+        source(source), args(args), numArgs(numArgs), scope(scope) {}
+
+    int32_t scan(std::string_view format) {
+        if (!Source::StableTokens)
+            scanStrings.clear();
+
+        int32_t matched = 0;
+        for (size_t i = 0; i < format.size(); i++) {
+            char c = format[i];
+            if (isSpace(c)) {
+                skipSpace();
+                continue;
+            }
+
+            if (c != '%' || (i + 1 < format.size() && format[i + 1] == '%')) {
+                if (c == '%')
+                    i++;
+
+                int next = source.peek();
+                if (next == EOF)
+                    return matched == 0 ? EOF : matched;
+                if (next != (unsigned char)c)
+                    return matched;
+
+                source.consume(1);
+                continue;
+            }
+
+            if (++i == format.size())
+                return matched;
+
+            bool suppress = format[i] == '*';
+            if (suppress && ++i == format.size())
+                return matched;
+
+            size_t maxWidth = 0;
+            while (i < format.size() && format[i] >= '0' && format[i] <= '9')
+                maxWidth = maxWidth * 10 + size_t(format[i++] - '0');
+
+            if (i == format.size())
+                return matched;
+
+            char conv = char(tolower(format[i]));
+            if (conv != 'c' && conv != 'm' && conv != 'u' && conv != 'z')
+                skipSpace();
+
+            if (conv != 'm' && source.peek() == EOF)
+                return matched == 0 ? EOF : matched;
+
+            ScanArg* arg = nullptr;
+            if (!suppress) {
+                if (argIndex >= numArgs)
+                    return matched;
+                arg = &args[argIndex++];
+            }
+
+            if (!convert(conv, maxWidth, arg))
+                return matched;
+
+            if (!suppress)
+                matched++;
+        }
+
+        return matched;
+    }
+
+private:
+    Source& source;
+    ScanArg* args;
+    uint32_t numArgs;
+    std::string_view scope;
+    uint32_t argIndex = 0;
+    SmallVectorSized<logic_t, 64> digits;
+
+    void skipSpace() {
+        while (isSpace(source.peek()))
+            source.consume(1);
+    }
+
+    // Matches the longest run of characters satisfying the predicate, limited to
+    // maxWidth if it's nonzero. The returned view points into the source.
+    template<typename Pred>
+    std::string_view takeWhile(Pred&& pred, size_t maxWidth) {
+        size_t want = 64;
+        while (true) {
+            auto window = source.window(want);
+            size_t limit = maxWidth ? std::min(maxWidth, window.size()) : window.size();
+
+            size_t n = 0;
+            while (n < limit && pred(window[n]))
+                n++;
+
+            if (n < window.size() || window.size() < want || n == maxWidth) {
+                source.consume(n);
+                return window.substr(0, n);
+            }
+            want *= 2;
+        }
+    }
+
+    bool convert(char conv, size_t maxWidth, ScanArg* arg) {
+        switch (conv) {
+            case 'c': {
+                int c = source.peek();
+                source.consume(1);
+                if (arg)
+                    storeInt(*arg, uint64_t(c));
+                return true;
+            }
+            case 'd':
+                return convertDecimal(maxWidth, arg);
+            case 'b':
+                return convertPow2(maxWidth, arg, LiteralBase::Binary);
+            case 'o':
+                return convertPow2(maxWidth, arg, LiteralBase::Octal);
+            case 'h':
+            case 'x':
+                return convertPow2(maxWidth, arg, LiteralBase::Hex);
+            case 'e':
+            case 'f':
+            case 'g':
+            case 't':
+                return convertReal(maxWidth, arg);
+            case 's':
+                return convertString(maxWidth, arg);
+            case 'u':
+            case 'z':
+                return convertRaw(conv == 'z', arg);
+            case 'm':
+                // Produces the hierarchical path of the calling scope without reading anything.
+                if (arg && arg->kind == ScanArgKind::String)
+                    *static_cast<ScanString*>(arg->data) = { scope.data(), scope.size() };
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool convertDecimal(size_t maxWidth, ScanArg* arg) {
+        bool negative = false;
+        int c = source.peek();
+        if (c == '+' || c == '-') {
+            negative = c == '-';
+            source.consume(1);
+            if (maxWidth && --maxWidth == 0)
+                return false;
+        }
+
+        auto token = takeWhile(
+            [](char ch) { return (ch >= '0' && ch <= '9') || ch == '_' || isUnknownDigit(ch); },
+            maxWidth);
+        if (token.empty())
+            return false;
+        if (!arg)
+            return true;
+
+        if (isUnknownDigit(token[0])) {
+            bool isZ = token[0] != 'x' && token[0] != 'X';
+            uint32_t width = std::max(arg->width, 1u);
+            storeInt(*arg, isZ ? SVInt::createFillZ(width, false) : SVInt::createFillX(width, false));
+            return true;
+        }
+
+        // Fast path: small values are accumulated directly.
+        if (token.size() <= 19 && arg->width <= 64) {
+            uint64_t value = 0;
+            bool simple = true;
+            for (char ch : token) {
+                if (ch < '0' || ch > '9') {
+                    simple = ch == '_';
+                    if (!simple)
+                        break;
+                    continue;
+                }
+                value = value * 10 + uint64_t(ch - '0');
+            }
+
+            if (simple) {
+                if (arg->kind == ScanArgKind::Real || arg->kind == ScanArgKind::ShortReal)
+                    storeReal(*arg, negative ? -double(value) : double(value));
+                else
+                    storeInt(*arg, negative ? uint64_t(0) - value : value);
+                return true;
+            }
+        }
+
+        digits.clear();
+        for (char ch : token) {
+            if (ch >= '0' && ch <= '9')
+                digits.append(logic_t(uint8_t(ch - '0')));
+            else if (ch != '_')
+                return false;
+        }
+
+        if (digits.empty())
+            return false;
+
+        // Make sure the intermediate value is wide enough to hold every
+        // digit before truncating to the destination.
+        bitwidth_t bits = std::max(bitwidth_t(digits.size() * 4 + 1), bitwidth_t(arg->width));
+        SVInt value = SVInt::fromDigits(bits, LiteralBase::Decimal, true, false, digits);
+        storeInt(*arg, negative ? -value : value);
+        return true;
+    }
+
+    bool convertPow2(size_t maxWidth, ScanArg* arg, LiteralBase base) {
+        uint32_t radix = base == LiteralBase::Binary ? 2 : base == LiteralBase::Octal ? 8 : 16;
+        auto digitValue = [radix](char ch) -> int {
+            int v;
+            if (ch >= '0' && ch <= '9')
+                v = ch - '0';
+            else if (ch >= 'a' && ch <= 'f')
+                v = ch - 'a' + 10;
+            else if (ch >= 'A' && ch <= 'F')
+                v = ch - 'A' + 10;
+            else
+                return -1;
+            return v < int(radix) ? v : -1;
+        };
+
+        auto token = takeWhile(
+            [&](char ch) { return digitValue(ch) >= 0 || ch == '_' || isUnknownDigit(ch); },
+            maxWidth);
+        if (token.empty())
+            return false;
+        if (!arg)
+            return true;
+
+        uint32_t shift = radix == 2 ? 1 : radix == 8 ? 3 : 4;
+        bool anyUnknown = false;
+        bool fits = arg->width <= 64;
+        uint64_t value = 0;
+        digits.clear();
+
+        for (char ch : token) {
+            if (ch == '_')
+                continue;
+
+            if (isUnknownDigit(ch)) {
+                anyUnknown = true;
+                digits.append(ch == 'x' || ch == 'X' ? logic_t::x : logic_t::z);
+            }
+            else {
+                uint8_t v = uint8_t(digitValue(ch));
+                digits.append(logic_t(v));
+                value = (value << shift) | v;
+            }
+        }
+
+        if (digits.empty())
+            return false;
+
+        if (fits && !anyUnknown && digits.size() * shift <= 64) {
+            storeInt(*arg, value);
+            return true;
+        }
+
+        bitwidth_t bits = std::max(bitwidth_t(digits.size() * shift), bitwidth_t(arg->width));
+        storeInt(*arg, SVInt::fromDigits(bits, base, false, anyUnknown, digits));
+        return true;
+    }
+
+    bool convertReal(size_t maxWidth, ScanArg* arg) {
+        auto token = takeWhile(
+            [](char ch) {
+                return (ch >= '0' && ch <= '9') || ch == '.' || ch == '+' || ch == '-' ||
+                       ch == 'e' || ch == 'E' || ch == '_';
+            },
+            maxWidth);
+
+        char buf[128];
+        size_t len = 0;
+        for (char ch : token) {
+            if (ch != '_' && len < sizeof(buf) - 1)
+                buf[len++] = ch;
+        }
+        buf[len] = '\0';
+
+        char* endPtr;
+        double value = strtod(buf, &endPtr);
+        if (endPtr == buf)
+            return false;
+
+        if (arg)
+            storeReal(*arg, value);
+        return true;
+    }
+
+    bool convertString(size_t maxWidth, ScanArg* arg) {
+        auto token = takeWhile([](char ch) { return !isSpace(ch); }, maxWidth);
+        if (token.empty())
+            return false;
+        if (!arg)
+            return true;
+
+        if (arg->kind == ScanArgKind::String) {
+            if (!Source::StableTokens) {
+                scanStrings.emplace_back(token);
+                token = scanStrings.back();
+            }
+            *static_cast<ScanString*>(arg->data) = { token.data(), token.size() };
+        }
+        else {
+            storeChars(*arg, token);
+        }
+        return true;
+    }
+
+    bool convertRaw(bool isFourState, ScanArg* arg) {
+        if (arg && arg->kind != ScanArgKind::TwoState && arg->kind != ScanArgKind::FourState)
+            return false;
+
+        uint32_t width = arg ? arg->width : 32;
+        size_t bytes = (width + 7) / 8;
+        size_t total = isFourState ? bytes * 2 : bytes;
+
+        auto window = source.window(total);
+        if (window.size() < total)
+            return false;
+
+        if (arg) {
+            auto dest = clearStorage(static_cast<uint64_t*>(arg->data), width,
+                                     arg->kind == ScanArgKind::FourState);
+            auto copyBits = [&](const char* src, uint32_t offset) {
+                for (size_t i = 0; i < bytes; i++) {
+                    uint32_t bit = uint32_t(i * 8);
+                    uint64_t b = (unsigned char)src[i];
+                    if (width - bit < 8)
+                        b &= (1ull << (width - bit)) - 1;
+                    insertBits(dest, offset + bit, &b, std::min(8u, width - bit));
+                }
+            };
+
+            copyBits(window.data(), 0);
+            if (isFourState && arg->kind == ScanArgKind::FourState)
+                copyBits(window.data() + bytes, width);
+        }
+
+        source.consume(total);
+        return true;
+    }
+};
+
+} // namespace
+
+/// Opens a file and returns its descriptor. An empty mode opens the
+/// file for writing and returns a multichannel descriptor instead.
+EXPORT uint32_t fileOpen(const char* path, size_t pathLen, const char* mode, size_t modeLen) {
+    return FileTable::instance().open(std::string_view(path, pathLen),
+                                      std::string_view(mode, modeLen));
+}
+
+EXPORT void fileClose(uint32_t fd) {
+    FileTable::instance().close(fd);
+}
+
+EXPORT int32_t fileGetc(uint32_t fd) {
+    auto file = FileTable::instance().get(fd);
+    return file ? file->getc() : EOF;
+}
+
+EXPORT int32_t fileUngetc(int32_t c, uint32_t fd) {
+    auto file = FileTable::instance().get(fd);
+    return file && file->ungetc(c) ? 0 : EOF;
+}
+
+/// Reads a line into an integral variable, storing at most width / 8 characters.
+/// Returns the number of characters read, or zero on error.
+EXPORT int32_t fileGets(uint32_t fd, uint64_t* storage, uint32_t width, bool isFourState) {
+    auto file = FileTable::instance().get(fd);
+    if (!file)
+        return 0;
+
+    size_t maxChars = width / 8;
+    auto window = file->window(maxChars);
+    auto nl = memchr(window.data(), '\n', std::min(window.size(), maxChars));
+    size_t count = nl ? size_t(static_cast<const char*>(nl) - window.data()) + 1
+                      : std::min(window.size(), maxChars);
+
+    ScanArg arg{ storage, width, isFourState ? ScanArgKind::FourState : ScanArgKind::TwoState };
+    storeChars(arg, window.substr(0, count));
+    file->consume(count);
+    return int32_t(count);
+}
+
+/// Reads a line (including its newline) for a string variable. The result points
+/// into the file's buffer and is only valid until the next I/O call.
+EXPORT int32_t fileGetLine(uint32_t fd, ScanString* result) {
+    *result = { "", 0 };
+    auto file = FileTable::instance().get(fd);
+    if (!file)
+        return 0;
+
+    size_t want = 256;
+    while (true) {
+        auto window = file->window(want);
+        auto nl = memchr(window.data(), '\n', window.size());
+        if (nl || window.size() < want) {
+            size_t count = nl ? size_t(static_cast<const char*>(nl) - window.data()) + 1
+                              : window.size();
+            *result = { window.data(), count };
+            file->consume(count);
+            return int32_t(count);
+        }
+        want *= 2;
+    }
+}
+
+/// Scans formatted input from the file. @a scope is the hierarchical path of the
+/// calling scope, which is what a %m conversion produces.
+EXPORT int32_t fileScanf(uint32_t fd, const char* format, size_t formatLen, ScanArg* args,
+                         uint32_t numArgs, const char* scope, size_t scopeLen) {
+    auto file = FileTable::instance().get(fd);
+    if (!file)
+        return EOF;
+
+    FileSource source{ *file };
+    return Scanner<FileSource>(source, args, numArgs, std::string_view(scope, scopeLen))
+        .scan(std::string_view(format, formatLen));
+}
+
+/// Scans formatted input from a string, as with fileScanf.
+EXPORT int32_t stringScanf(const char* str, size_t strLen, const char* format, size_t formatLen,
+                           ScanArg* args, uint32_t numArgs, const char* scope, size_t scopeLen) {
+    StringSource source{ std::string_view(str, strLen) };
+    return Scanner<StringSource>(source, args, numArgs, std::string_view(scope, scopeLen))
+        .scan(std::string_view(format, formatLen));
+}
+
+/// Reads binary data into an integral variable, most significant byte first.
+/// Returns the number of bytes read.
+EXPORT int32_t fileRead(uint32_t fd, uint64_t* storage, uint32_t width, bool isFourState) {
+    auto file = FileTable::instance().get(fd);
+    if (!file)
+        return 0;
+
+    size_t numBytes = (width + 7) / 8;
+    auto window = file->window(numBytes);
+    size_t count = std::min(window.size(), numBytes);
+    if (count) {
+        storeBigEndian(storage, width, isFourState, window.data(), count);
+        file->consume(count);
+    }
+    return int32_t(count);
+}
+
+/// Reads binary data into consecutive elements of an unpacked array. Each element
+/// occupies a whole number of 64-bit words, as with readMemory. Returns the number
+/// of bytes read; a trailing partial element is stored as if it were complete.
+EXPORT int64_t fileReadMemory(uint32_t fd, uint64_t* storage, uint32_t elemWidth,
+                              bool isFourState, uint64_t count) {
+    auto file = FileTable::instance().get(fd);
+    if (!file)
+        return 0;
+
+    const size_t elemBytes = (elemWidth + 7) / 8;
+    const size_t stride = getStorageWords(elemWidth, isFourState);
+
+    // Convert straight out of the file buffer, a window's worth of elements at a time.
+    const size_t batch = std::max(size_t(1), BufferedFile::BufferSize / 2 / elemBytes);
+    int64_t total = 0;
+    uint64_t elem = 0;
+    while (elem < count) {
+        size_t want = size_t(std::min(uint64_t(batch), count - elem)) * elemBytes;
+        auto window = file->window(want);
+        if (window.empty())
+            break;
+
+        size_t avail = std::min(window.size(), want);
+        const char* ptr = window.data();
+        for (size_t offset = 0; offset < avail; offset += elemBytes, elem++) {
+            size_t n = std::min(elemBytes, avail - offset);
+            storeBigEndian(storage + elem * stride, elemWidth, isFourState, ptr + offset, n);
+        }
+
+        file->consume(avail);
+        total += int64_t(avail);
+        if (avail < want)
+            break;
+    }
+
+    return total;
+}
+
+/// Returns nonzero once a read on the descriptor has run into the end of the file,
+/// as with feof. Checking doesn't read anything itself, so a file that is being
+/// written is never at EOF.
+EXPORT int32_t fileEof(uint32_t fd) {
+    auto file = FileTable::instance().get(fd);
+    return !file || file->eof();
+}
+
+/// Gets the most recent error for the descriptor and a description of it.
+/// Passing a descriptor of zero reports the last failed $fopen.
+EXPORT int32_t fileError(uint32_t fd, ScanString* message) {
+    int code;
+    if (fd == 0) {
+        code = FileTable::instance().takeOpenError();
+    }
+    else {
+        auto file = FileTable::instance().get(fd);
+        code = file ? file->takeError() : EBADF;
+    }
+
+    const char* text = code ? strerror(code) : "";
+    *message = { text, strlen(text) };
+    return code;
+}
+
+EXPORT void fileFlush(uint32_t fd) {
+    FileTable::instance().flush(fd);
+}
+
+EXPORT int32_t fileSeek(uint32_t fd, int64_t offset, int32_t operation) {
+    auto file = FileTable::instance().get(fd);
+    int origin = operation == 1 ? SEEK_CUR : operation == 2 ? SEEK_END : SEEK_SET;
+    return file && file->seek(offset, origin) ? 0 : EOF;
+}
+
+EXPORT int64_t fileTell(uint32_t fd) {
+    auto file = FileTable::instance().get(fd);
+    return file ? file->tell() : EOF;
+}
+
+EXPORT int32_t fileRewind(uint32_t fd) {
+    return fileSeek(fd, 0, 0);
+}
+
+namespace slang::runtime {
+
+void getFileExports(ExportList& results) {
+#define ADD(name) results.emplace_back(#name, reinterpret_cast<uintptr_t>(&(name)));
+
+    ADD(fileOpen);
+    ADD(fileClose);
+    ADD(fileGetc);
+    ADD(fileUngetc);
+    ADD(fileGets);
+    ADD(fileGetLine);
+    ADD(fileScanf);
+    ADD(stringScanf);
+    ADD(fileRead);
+    ADD(fileReadMemory);
+    ADD(fileEof);
+    ADD(fileError);
+    ADD(fileFlush);
+    ADD(fileSeek);
+    ADD(fileTell);
+    ADD(fileRewind);
+
+#undef ADD
+}
+
+} // namespace slang::runtime
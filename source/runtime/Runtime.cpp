@@ -9,10 +9,14 @@
 namespace slang::runtime {
 
 void getIOExports(ExportList& results);
+void getFileExports(ExportList& results);
+void getWaveExports(ExportList& results);
 
 ExportList getExportedFunctions() {
     ExportList results;
     getIOExports(results);
+    getFileExports(results);
+    getWaveExports(results);
     
     return results;
 }
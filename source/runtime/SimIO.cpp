@@ -6,10 +6,14 @@
 //------------------------------------------------------------------------------
 #include <fmt/format.h>
 
+#include "slang/numeric/MemoryFile.h"
+#include "slang/runtime/FileIO.h"
 #include "slang/runtime/Runtime.h"
 #include "slang/text/SFormat.h"
 #include "slang/util/OS.h"
 
+#include "Storage.h"
+
 using namespace slang;
 
 // The global output buffer, printed to by exported I/O routines.
@@ -29,6 +33,21 @@ EXPORT void flush(bool newline) {
     outputBuffer.clear();
 }
 
+/// Like flush(), but sends the buffered output to the files named by
+/// a descriptor or multichannel descriptor ($fdisplay / $fwrite).
+EXPORT void flushToFile(uint32_t fd, bool newline) {
+    using slang::runtime::FileTable;
+    if (newline)
+        outputBuffer.push_back('\n');
+
+    std::string_view text(outputBuffer.data(), outputBuffer.size());
+    if (FileTable::includesStdout(fd))
+        outputHandler(text);
+
+    FileTable::instance().write(fd, text);
+    outputBuffer.clear();
+}
+
 EXPORT void printStr(const char* str, size_t len) {
     outputBuffer.append(str, str + len);
 }
@@ -45,6 +64,33 @@ EXPORT void printInt(const SVInt* value, LiteralBase base, uint32_t width, bool
     str.clear();
 }
 
+/// Loads a $readmemh / $readmemb file directly into simulation storage.
+/// Each memory word occupies a whole number of 64-bit words; four-state
+/// words store their unknown bits above the value bits. A negative start
+/// or finish address means the argument was not provided.
+EXPORT bool readMemory(const char* path, size_t pathLen, bool isHex, uint64_t* storage,
+                       uint32_t wordBits, bool isFourState, uint64_t lowAddress,
+                       uint64_t highAddress, int64_t start, int64_t finish) {
+    MemoryFile::Options options;
+    options.wordWidth = wordBits;
+    options.isHex = isHex;
+    options.lowAddress = lowAddress;
+    options.highAddress = highAddress;
+    if (start >= 0)
+        options.start = uint64_t(start);
+    if (finish >= 0)
+        options.finish = uint64_t(finish);
+
+    const size_t wordStride = runtime::getStorageWords(wordBits, isFourState);
+    auto result = MemoryFile::load(
+        std::string(path, pathLen), options, [&](uint64_t addr, SVInt&& value) {
+            runtime::storeValue(storage + (addr - lowAddress) * wordStride, wordBits,
+                                isFourState, value);
+        });
+
+    return bool(result);
+}
+
 namespace slang::runtime {
 
 void setOutputHandler(function_ref<void(std::string_view)> handler) {
@@ -55,8 +101,10 @@ void getIOExports(ExportList& results) {
 #define ADD(name) results.emplace_back(#name, reinterpret_cast<uintptr_t>(&(name)));
 
     ADD(flush);
+    ADD(flushToFile);
     ADD(printStr);
     ADD(printInt);
+    ADD(readMemory);
 
 #undef ADD
 }
@@ -0,0 +1,52 @@
+//------------------------------------------------------------------------------
+// Storage.h
+// Helpers for integral simulation storage
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "slang/numeric/SVInt.h"
+
+namespace slang::runtime {
+
+/// Gets the number of 64-bit words used to store an integral value of the given
+/// width. Four-state values keep their unknown bits packed directly after the
+/// value bits, starting at bit @a width.
+inline size_t getStorageWords(uint32_t width, bool isFourState) {
+    return ((isFourState ? size_t(width) * 2 : size_t(width)) + 63) / 64;
+}
+
+/// Copies @a numBits bits from @a src into @a dest starting at bit @a destOffset.
+/// The destination bits are OR-ed in, so they must already be clear.
+inline void insertBits(uint64_t* dest, uint32_t destOffset, const uint64_t* src,
+                       uint32_t numBits) {
+    for (uint32_t bit = 0; bit < numBits; bit += 64) {
+        uint32_t count = std::min(64u, numBits - bit);
+        uint64_t word = src[bit / 64];
+        if (count < 64)
+            word &= (1ull << count) - 1;
+
+        uint32_t pos = destOffset + bit;
+        uint32_t shift = pos % 64;
+        dest[pos / 64] |= word << shift;
+        if (shift && shift + count > 64)
+            dest[pos / 64 + 1] |= word >> (64 - shift);
+    }
+}
+
+/// Stores @a value, which must be @a width bits wide, into integral storage.
+/// Unknown bits are dropped if the storage is not four-state.
+inline void storeValue(uint64_t* dest, uint32_t width, bool isFourState, const SVInt& value) {
+    std::fill(dest, dest + getStorageWords(width, isFourState), 0);
+
+    const uint64_t* raw = value.getRawPtr();
+    insertBits(dest, 0, raw, width);
+    if (isFourState && value.hasUnknown())
+        insertBits(dest, width, raw + value.getNumWords() / 2, width);
+}
+
+} // namespace slang::runtime
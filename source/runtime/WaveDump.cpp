@@ -0,0 +1,598 @@
+//------------------------------------------------------------------------------
+// WaveDump.cpp
+// Simulation waveform dumping
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#include "slang/runtime/WaveDump.h"
+
+#include "Storage.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "slang/runtime/Runtime.h"
+#include "slang/util/Util.h"
+
+namespace {
+
+// The maximum number of completed blocks that may be waiting for the writer
+// before the simulation thread blocks to let it catch up.
+constexpr size_t MaxQueuedBlocks = 8;
+
+bool getBit(const uint64_t* data, uint32_t bit) {
+    return (data[bit / 64] >> (bit % 64)) & 1;
+}
+
+void appendVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(char(value));
+}
+
+// Appends `numBits` bits starting at bit `offset` of `data` as little-endian bytes.
+void appendBytes(std::string& out, const uint64_t* data, uint32_t offset, uint32_t numBits) {
+    for (uint32_t bit = 0; bit < numBits; bit += 8) {
+        uint8_t byte = 0;
+        uint32_t count = std::min(8u, numBits - bit);
+        for (uint32_t i = 0; i < count; i++)
+            byte |= uint8_t(getBit(data, offset + bit + i) << i);
+        out.push_back(char(byte));
+    }
+}
+
+// VCD identifier codes are strings of printable ASCII characters ('!' through '~').
+std::string makeCode(uint32_t index) {
+    std::string result;
+    do {
+        result.push_back(char('!' + index % 94));
+        index /= 94;
+    } while (index);
+    return result;
+}
+
+std::string_view getVarTypeName(slang::runtime::WaveVarKind kind) {
+    using slang::runtime::WaveVarKind;
+    switch (kind) {
+        case WaveVarKind::Reg:
+            return "reg";
+        case WaveVarKind::Integer:
+            return "integer";
+        case WaveVarKind::Time:
+            return "time";
+        default:
+            return "wire";
+    }
+}
+
+bool isInScope(std::string_view scope, std::string_view root, uint32_t levels) {
+    size_t depth = 0;
+    if (!root.empty()) {
+        if (scope.substr(0, root.size()) != root)
+            return false;
+        if (scope.size() > root.size() && scope[root.size()] != '.')
+            return false;
+        scope = scope.substr(std::min(scope.size(), root.size() + 1));
+    }
+
+    if (!scope.empty())
+        depth = size_t(std::count(scope.begin(), scope.end(), '.')) + 1;
+
+    return levels == 0 || depth < levels;
+}
+
+} // namespace
+
+namespace slang::runtime {
+
+double WaveDumper::Stats::overheadPercent() const {
+    if (totalTime.count() == 0)
+        return 0.0;
+    return 100.0 * double(dumpTime.count()) / double(totalTime.count());
+}
+
+WaveDumper::WaveDumper(const std::string& path, WaveFormat format, size_t blockSize) :
+    format(format), blockSize(std::max(blockSize, size_t(4096))), startTime(Clock::now()) {
+
+    file = fopen(path.c_str(), "wb");
+}
+
+WaveDumper::~WaveDumper() {
+    close();
+}
+
+uint32_t WaveDumper::addSignal(std::string_view scopePath, std::string_view name, uint32_t width,
+                               bool isFourState, WaveVarKind kind) {
+    ASSERT(!started);
+    ASSERT(width);
+
+    Signal signal;
+    signal.scope = std::string(scopePath);
+    signal.name = std::string(name);
+    signal.width = width;
+    signal.isFourState = isFourState;
+    signal.kind = kind;
+    signal.words = uint32_t(getStorageWords(width, isFourState));
+
+    signals.emplace_back(std::move(signal));
+    return uint32_t(signals.size() - 1);
+}
+
+void WaveDumper::selectScope(std::string_view scopePath, uint32_t levels) {
+    if (started)
+        return;
+
+    for (auto& signal : signals) {
+        if (isInScope(signal.scope, scopePath, levels))
+            signal.selected = true;
+    }
+}
+
+void WaveDumper::selectSignal(uint32_t id) {
+    ASSERT(id < signals.size());
+    if (!started)
+        signals[id].selected = true;
+}
+
+void WaveDumper::setEnabled(bool value) {
+    enabled = value;
+}
+
+void WaveDumper::setTime(uint64_t time) {
+    if (!file)
+        return;
+
+    auto begin = Clock::now();
+    if (!started)
+        start();
+
+    if (time != currentTime) {
+        currentTime = time;
+        timestepOpen = false;
+
+        // Hand off completed timesteps once enough have accumulated.
+        if (pending.data.size() * sizeof(uint64_t) >= blockSize)
+            submit(false);
+    }
+
+    dumpTime += Clock::now() - begin;
+}
+
+void WaveDumper::valueChanged(uint32_t id, const uint64_t* data) {
+    ASSERT(id < signals.size());
+    if (!file || !enabled)
+        return;
+
+    auto begin = Clock::now();
+    if (!started)
+        start();
+
+    const Signal& signal = signals[id];
+    if (signal.selected) {
+        auto& buffer = pending.data;
+        if (!timestepOpen) {
+            buffer.push_back(TimeMarker);
+            buffer.push_back(currentTime);
+            timestepOpen = true;
+        }
+
+        buffer.push_back(id);
+        buffer.insert(buffer.end(), data, data + signal.words);
+        changes++;
+    }
+
+    dumpTime += Clock::now() - begin;
+}
+
+void WaveDumper::flush() {
+    if (!file)
+        return;
+
+    auto begin = Clock::now();
+    if (!started)
+        start();
+
+    submit(true);
+    dumpTime += Clock::now() - begin;
+}
+
+void WaveDumper::close() {
+    if (!file)
+        return;
+
+    flush();
+    if (writer.joinable()) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        writer.join();
+    }
+
+    fclose(file);
+    file = nullptr;
+}
+
+WaveDumper::Stats WaveDumper::getStats() const {
+    Stats stats;
+    stats.changes = changes;
+    stats.dumpTime = dumpTime;
+    stats.totalTime = Clock::now() - startTime;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    stats.bytesWritten = bytesWritten;
+    stats.writerTime = writerTime;
+    return stats;
+}
+
+void WaveDumper::start() {
+    started = true;
+
+    uint32_t index = 0;
+    for (auto& signal : signals) {
+        if (signal.selected) {
+            signal.code = makeCode(index);
+            signal.index = index++;
+        }
+    }
+
+    std::string header;
+    encodeHeader(header);
+    writeOut(header, true);
+
+    pending.data.reserve(blockSize / sizeof(uint64_t) + 64);
+    writer = std::thread([this] { writerMain(); });
+}
+
+void WaveDumper::submit(bool wait) {
+    Block block;
+    block.flush = wait;
+    if (!wait && pending.data.empty())
+        return;
+
+    std::swap(block.data, pending.data);
+    pending.data.reserve(blockSize / sizeof(uint64_t) + 64);
+
+    // If more changes arrive for the current timestep they start a new record
+    // with the same time; the VCD encoder merges them back together.
+    timestepOpen = false;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this] { return queue.size() < MaxQueuedBlocks; });
+
+    queue.emplace_back(std::move(block));
+    cv.notify_all();
+
+    if (wait)
+        cv.wait(lock, [this] { return queue.empty() && writerIdle; });
+}
+
+void WaveDumper::writerMain() {
+    std::string out;
+    out.reserve(blockSize * 2);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        cv.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty())
+            break;
+
+        Block block = std::move(queue.front());
+        queue.pop_front();
+        writerIdle = false;
+        cv.notify_all();
+        lock.unlock();
+
+        auto begin = Clock::now();
+        encodeBlock(block, out);
+        if (block.flush) {
+            if (format == WaveFormat::ChangeLog)
+                finishChangeLogStep(out);
+            else
+                finishDumpVars(out);
+            writeOut(out, true);
+            fflush(file);
+        }
+        else {
+            writeOut(out, false);
+        }
+        auto elapsed = Clock::now() - begin;
+
+        lock.lock();
+        writerTime += elapsed;
+        writerIdle = true;
+        cv.notify_all();
+    }
+}
+
+void WaveDumper::encodeHeader(std::string& out) const {
+    if (format == WaveFormat::ChangeLog) {
+        out.append("SLWV");
+        out.push_back(1);
+
+        uint64_t count = 0;
+        for (auto& signal : signals)
+            count += signal.selected;
+        appendVarint(out, count);
+
+        for (auto& signal : signals) {
+            if (!signal.selected)
+                continue;
+
+            std::string name = signal.scope.empty() ? signal.name
+                                                    : signal.scope + "." + signal.name;
+            appendVarint(out, signal.width);
+            out.push_back(char(signal.isFourState));
+            appendVarint(out, name.size());
+            out.append(name);
+        }
+        return;
+    }
+
+    out.append("$timescale ");
+    out.append(timeScale);
+    out.append(" $end\n");
+
+    // Group signals by scope so that each scope is opened exactly once.
+    std::vector<const Signal*> sorted;
+    for (auto& signal : signals) {
+        if (signal.selected)
+            sorted.push_back(&signal);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](auto a, auto b) { return a->scope < b->scope; });
+
+    std::vector<std::string_view> openScopes;
+    for (auto signal : sorted) {
+        std::vector<std::string_view> path;
+        std::string_view scope = signal->scope;
+        while (!scope.empty()) {
+            size_t dot = scope.find('.');
+            path.push_back(scope.substr(0, dot));
+            scope = dot == std::string_view::npos ? std::string_view() : scope.substr(dot + 1);
+        }
+
+        size_t common = 0;
+        while (common < openScopes.size() && common < path.size() &&
+               openScopes[common] == path[common]) {
+            common++;
+        }
+
+        for (size_t i = openScopes.size(); i > common; i--)
+            out.append("$upscope $end\n");
+        openScopes.resize(common);
+
+        for (size_t i = common; i < path.size(); i++) {
+            out.append("$scope module ");
+            out.append(path[i]);
+            out.append(" $end\n");
+            openScopes.push_back(path[i]);
+        }
+
+        out.append("$var ");
+        out.append(getVarTypeName(signal->kind));
+        out.push_back(' ');
+        out.append(std::to_string(signal->width));
+        out.push_back(' ');
+        out.append(signal->code);
+        out.push_back(' ');
+        out.append(signal->name);
+        out.append(" $end\n");
+    }
+
+    for (size_t i = 0; i < openScopes.size(); i++)
+        out.append("$upscope $end\n");
+    out.append("$enddefinitions $end\n");
+}
+
+void WaveDumper::encodeBlock(const Block& block, std::string& out) {
+    const uint64_t* ptr = block.data.data();
+    const uint64_t* end = ptr + block.data.size();
+    while (ptr != end) {
+        if (*ptr == TimeMarker) {
+            uint64_t time = ptr[1];
+            ptr += 2;
+
+            if (format == WaveFormat::ChangeLog) {
+                finishChangeLogStep(out);
+                appendVarint(out, time - lastWrittenTime);
+                stepOpen = true;
+            }
+            else if (!anyTimeWritten || time != lastWrittenTime) {
+                finishDumpVars(out);
+                out.push_back('#');
+                out.append(std::to_string(time));
+                out.push_back('\n');
+
+                // The first timestep holds the initial values of all dumped signals.
+                if (!anyTimeWritten) {
+                    out.append("$dumpvars\n");
+                    inDumpVars = true;
+                    initialDumped.assign(signals.size(), false);
+                }
+            }
+
+            lastWrittenTime = time;
+            anyTimeWritten = true;
+            continue;
+        }
+
+        const Signal& signal = signals[size_t(*ptr++)];
+        if (format == WaveFormat::ChangeLog) {
+            appendVarint(stepChanges, signal.index);
+            encodeChangeLogValue(signal, ptr, stepChanges);
+            stepChangeCount++;
+        }
+        else {
+            encodeVCDValue(signal, ptr, out);
+            if (inDumpVars)
+                initialDumped[signal.index] = true;
+        }
+        ptr += signal.words;
+    }
+}
+
+void WaveDumper::encodeVCDValue(const Signal& signal, const uint64_t* data,
+                                std::string& out) const {
+    auto bitChar = [&](uint32_t bit) {
+        bool value = getBit(data, bit);
+        if (signal.isFourState && getBit(data, signal.width + bit))
+            return value ? 'z' : 'x';
+        return value ? '1' : '0';
+    };
+
+    if (signal.width == 1) {
+        out.push_back(bitChar(0));
+        out.append(signal.code);
+        out.push_back('\n');
+        return;
+    }
+
+    // Leading zeros are implied by VCD readers, so skip them.
+    uint32_t bit = signal.width;
+    while (bit > 1 && bitChar(bit - 1) == '0')
+        bit--;
+
+    out.push_back('b');
+    while (bit > 0)
+        out.push_back(bitChar(--bit));
+    out.push_back(' ');
+    out.append(signal.code);
+    out.push_back('\n');
+}
+
+void WaveDumper::encodeChangeLogValue(const Signal& signal, const uint64_t* data,
+                                      std::string& out) const {
+    appendBytes(out, data, 0, signal.width);
+    if (signal.isFourState)
+        appendBytes(out, data, signal.width, signal.width);
+}
+
+void WaveDumper::finishChangeLogStep(std::string& out) {
+    if (!stepOpen)
+        return;
+
+    appendVarint(out, stepChangeCount);
+    out.append(stepChanges);
+    stepChanges.clear();
+    stepChangeCount = 0;
+    stepOpen = false;
+}
+
+void WaveDumper::finishDumpVars(std::string& out) {
+    if (!inDumpVars)
+        return;
+
+    // Every variable needs an initial value, so fill in any that weren't recorded.
+    for (auto& signal : signals) {
+        if (!signal.selected || initialDumped[signal.index])
+            continue;
+
+        char value = signal.isFourState ? 'x' : '0';
+        if (signal.width == 1) {
+            out.push_back(value);
+        }
+        else {
+            out.push_back('b');
+            out.push_back(value);
+            out.push_back(' ');
+        }
+        out.append(signal.code);
+        out.push_back('\n');
+    }
+
+    out.append("$end\n");
+    inDumpVars = false;
+}
+
+void WaveDumper::writeOut(std::string& out, bool force) {
+    if (out.empty() || (!force && out.size() < blockSize))
+        return;
+
+    size_t written = fwrite(out.data(), 1, out.size(), file);
+    out.clear();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    bytesWritten += written;
+}
+
+} // namespace slang::runtime
+
+using namespace slang::runtime;
+
+// The dumper driven by the $dump* family of system tasks.
+static std::unique_ptr<WaveDumper> waveDumper;
+
+EXPORT bool waveOpen(const char* path, size_t pathLen, bool binary) {
+    waveDumper = std::make_unique<WaveDumper>(std::string(path, pathLen),
+                                              binary ? WaveFormat::ChangeLog : WaveFormat::VCD);
+    return waveDumper->isOpen();
+}
+
+EXPORT uint32_t waveDeclare(const char* scope, size_t scopeLen, const char* name, size_t nameLen,
+                            uint32_t width, bool isFourState, uint8_t kind) {
+    if (!waveDumper)
+        return 0;
+    if (kind > uint8_t(WaveVarKind::Time))
+        kind = uint8_t(WaveVarKind::Wire);
+    return waveDumper->addSignal(std::string_view(scope, scopeLen),
+                                 std::string_view(name, nameLen), width, isFourState,
+                                 WaveVarKind(kind));
+}
+
+EXPORT void waveDumpScope(const char* scope, size_t scopeLen, uint32_t levels) {
+    if (waveDumper)
+        waveDumper->selectScope(std::string_view(scope, scopeLen), levels);
+}
+
+EXPORT void waveDumpSignal(uint32_t id) {
+    if (waveDumper)
+        waveDumper->selectSignal(id);
+}
+
+EXPORT void waveTime(uint64_t time) {
+    if (waveDumper)
+        waveDumper->setTime(time);
+}
+
+EXPORT void waveChange(uint32_t id, const uint64_t* data) {
+    if (waveDumper)
+        waveDumper->valueChanged(id, data);
+}
+
+EXPORT void waveEnable(bool enabled) {
+    if (waveDumper)
+        waveDumper->setEnabled(enabled);
+}
+
+EXPORT void waveFlush() {
+    if (waveDumper)
+        waveDumper->flush();
+}
+
+EXPORT void waveClose() {
+    waveDumper.reset();
+}
+
+namespace slang::runtime {
+
+void getWaveExports(ExportList& results) {
+#define ADD(name) results.emplace_back(#name, reinterpret_cast<uintptr_t>(&(name)));
+
+    ADD(waveOpen);
+    ADD(waveDeclare);
+    ADD(waveDumpScope);
+    ADD(waveDumpSignal);
+    ADD(waveTime);
+    ADD(waveChange);
+    ADD(waveEnable);
+    ADD(waveFlush);
+    ADD(waveClose);
+
+#undef ADD
+}
+
+} // namespace slang::runtime
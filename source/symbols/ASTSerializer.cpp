@@ -134,6 +134,15 @@ void ASTSerializer::endObject() {
 template<typename T>
 void ASTSerializer::visit(const T& elem) {
     if constexpr (std::is_base_of_v<Expression, T>) {
+        // Literals produced by constant folding are written out as the
+        // expression they replaced, so that output doesn't depend on folding.
+        if constexpr (std::is_same_v<IntegerLiteral, T> || std::is_same_v<RealLiteral, T>) {
+            if (elem.foldedFrom) {
+                serialize(*elem.foldedFrom);
+                return;
+            }
+        }
+
         writer.startObject();
         write("kind", toString(elem.kind));
         write("type", *elem.type);
@@ -197,10 +206,17 @@ void ASTSerializer::visit(const T& elem) {
         }
 
         if constexpr (std::is_base_of_v<Scope, T>) {
-            if (!elem.empty()) {
+            auto gates = elem.getGateTable();
+            if (!elem.empty() || gates) {
                 startArray("members");
                 for (auto& member : elem.members())
                     serialize(member);
+
+                // Gates kept in compact form are written out like any other member.
+                if (gates) {
+                    for (size_t i = 0; i < gates->size(); i++)
+                        serialize(gates->getSymbol(i));
+                }
                 endArray();
             }
         }
@@ -551,6 +551,9 @@ GenerateBlockArraySymbol& GenerateBlockArraySymbol::fromSyntax(
             return *result;
         }
 
+        if (compilation.checkBudget(parent, syntax.keyword.location()))
+            return *result;
+
         auto stop = stopExpr.eval(evalContext);
         if (stop.bad() || !stop.isTrue()) {
             result->valid = !stop.bad();
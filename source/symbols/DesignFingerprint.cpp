@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+// DesignFingerprint.cpp
+// Stable structural hashing of an elaborated design
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#include "slang/symbols/DesignFingerprint.h"
+
+#include "slang/compilation/Compilation.h"
+#include "slang/compilation/Definition.h"
+#include "slang/symbols/ASTSerializer.h"
+#include "slang/symbols/BlockSymbols.h"
+#include "slang/symbols/CompilationUnitSymbols.h"
+#include "slang/symbols/InstanceSymbols.h"
+#include "slang/symbols/PortSymbols.h"
+#include "slang/text/Json.h"
+#include "slang/util/Hash.h"
+
+namespace slang {
+
+static std::string toHex(uint64_t value) {
+    static const char digits[] = "0123456789abcdef";
+    std::string result(16, '0');
+    for (int i = 15; i >= 0; i--) {
+        result[size_t(i)] = digits[value & 0xf];
+        value >>= 4;
+    }
+    return result;
+}
+
+static uint64_t combine(uint64_t seed, const std::vector<DesignFingerprint::Node>& nodes) {
+    std::vector<uint64_t> values;
+    values.reserve(nodes.size() + 1);
+    values.push_back(seed);
+    for (auto& node : nodes)
+        values.push_back(node.subtreeHash);
+
+    return XXH3_64bits(values.data(), values.size() * sizeof(uint64_t));
+}
+
+DesignFingerprint::DesignFingerprint(Compilation& compilation) : compilation(compilation) {
+    for (auto inst : compilation.getRoot().topInstances)
+        topNodes.push_back(hashInstance(*inst));
+
+    designHash = combine(0, topNodes);
+}
+
+DesignFingerprint::Node DesignFingerprint::hashInstance(const InstanceSymbol& instance) {
+    Node node;
+    node.instance = &instance;
+    hashChildren(instance.body, node.children);
+
+    // Serialize the body without addresses or nested bodies; the serialized form has
+    // no locations or trivia in it, which makes it a good basis for the hash. Port
+    // connections for children are part of this body, so add them in as well.
+    JsonWriter writer;
+    ASTSerializer serializer(compilation, writer);
+    serializer.setIncludeAddresses(false);
+    serializer.setIncludeInstanceBodies(false);
+
+    writer.startArray();
+    serializer.serialize(instance.body);
+
+    for (auto& child : node.children) {
+        auto& childInst = *child.instance;
+        writer.startArray();
+        for (auto port : childInst.body.getPortList()) {
+            writer.writeValue(port->name);
+            if (port->kind == SymbolKind::Port) {
+                auto conn = childInst.getPortConnection(port->as<PortSymbol>());
+                if (conn && conn->expr)
+                    serializer.serialize(*conn->expr);
+            }
+            else if (port->kind == SymbolKind::InterfacePort) {
+                auto conn = childInst.getPortConnection(port->as<InterfacePortSymbol>());
+                if (conn && conn->ifaceInstance) {
+                    std::string path;
+                    conn->ifaceInstance->getHierarchicalPath(path);
+                    writer.writeValue(path);
+                }
+            }
+        }
+        writer.endArray();
+    }
+    writer.endArray();
+
+    auto text = writer.view();
+    node.bodyHash = XXH3_64bits(text.data(), text.size());
+    node.subtreeHash = combine(node.bodyHash, node.children);
+    return node;
+}
+
+void DesignFingerprint::hashChildren(const Scope& scope, std::vector<Node>& results) {
+    // Instances can be nested inside generate blocks and instance arrays,
+    // so look through any child scopes to find them.
+    for (auto& member : scope.members()) {
+        if (member.kind == SymbolKind::Instance)
+            results.push_back(hashInstance(member.as<InstanceSymbol>()));
+        else if (member.kind == SymbolKind::GenerateBlock &&
+                 !member.as<GenerateBlockSymbol>().isInstantiated)
+            continue;
+        else if (member.isScope())
+            hashChildren(member.as<Scope>(), results);
+    }
+}
+
+static void serializeNode(JsonWriter& writer, const DesignFingerprint::Node& node) {
+    std::string path;
+    node.instance->getHierarchicalPath(path);
+
+    writer.startObject();
+    writer.writeProperty("path");
+    writer.writeValue(path);
+    writer.writeProperty("definition");
+    writer.writeValue(node.instance->getDefinition().name);
+    writer.writeProperty("body");
+    writer.writeValue(toHex(node.bodyHash));
+    writer.writeProperty("subtree");
+    writer.writeValue(toHex(node.subtreeHash));
+
+    if (!node.children.empty()) {
+        writer.writeProperty("children");
+        writer.startArray();
+        for (auto& child : node.children)
+            serializeNode(writer, child);
+        writer.endArray();
+    }
+
+    writer.endObject();
+}
+
+void DesignFingerprint::serialize(JsonWriter& writer) const {
+    writer.startObject();
+    writer.writeProperty("design");
+    writer.writeValue(toHex(designHash));
+    writer.writeProperty("instances");
+    writer.startArray();
+    for (auto& node : topNodes)
+        serializeNode(writer, node);
+    writer.endArray();
+    writer.endObject();
+}
+
+} // namespace slang
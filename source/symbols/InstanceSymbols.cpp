@@ -443,7 +443,8 @@ void InstanceSymbol::getArrayDimensions(SmallVector<ConstantRange>& dimensions)
 }
 
 void InstanceSymbol::serializeTo(ASTSerializer& serializer) const {
-    serializer.write("body", body);
+    if (serializer.includesInstanceBodies())
+        serializer.write("body", body);
 }
 
 InstanceBodySymbol::InstanceBodySymbol(Compilation& compilation, const InstanceCacheKey& cacheKey,
@@ -506,6 +507,11 @@ const InstanceBodySymbol& InstanceBodySymbol::fromDefinition(
 
     // Finally add members from the body.
     for (auto member : declSyntax.members) {
+        // If the compilation has been cancelled, stop adding members; the body
+        // is left valid but incomplete, and nothing will look at it again.
+        if (comp.isCancelled())
+            break;
+
         // If this is a parameter declaration, we should already have metadata for it in our
         // parameters list. The list is given in declaration order, so we should be be able to move
         // through them incrementally.
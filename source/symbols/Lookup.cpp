@@ -1011,13 +1011,11 @@ void Lookup::unqualifiedImpl(const Scope& scope, string_view name, LookupLocatio
                              optional<SourceRange> sourceRange, bitmask<LookupFlags> flags,
                              SymbolIndex outOfBlockIndex, LookupResult& result) {
     // Try a simple name lookup to see if we find anything.
-    auto& nameMap = scope.getNameMap();
-    const Symbol* symbol = nullptr;
-    if (auto it = nameMap.find(name); it != nameMap.end()) {
+    const Symbol* symbol = scope.findNameMapEntry(name);
+    if (symbol) {
         // If the lookup is for a local name, check that we can access the symbol (it must be
         // declared before use). Callables and block names can be referenced anywhere in the
         // scope, so the location doesn't matter for them.
-        symbol = it->second;
         bool locationGood = true;
         if (!flags.has(LookupFlags::AllowDeclaredAfter)) {
             locationGood = LookupLocation::before(*symbol) < location;
@@ -407,12 +407,21 @@ Symbol* recurseGateArray(Compilation& compilation, GateType gateType,
 
 void GateSymbol::fromSyntax(Compilation& compilation, const GateInstantiationSyntax& syntax,
                             LookupLocation location, const Scope& scope,
-                            SmallVector<const Symbol*>& results) {
+                            SmallVector<const Symbol*>& results, GateTable* table) {
     // TODO: strengths and delays
     auto gateType = SemanticFacts::getGateType(syntax.gateType.kind);
 
+    // Attributes are stored per symbol, so gates that have them always get one.
+    if (!syntax.attributes.empty())
+        table = nullptr;
+
     BindContext context(scope, location, BindFlags::Constant);
     for (auto instance : syntax.instances) {
+        if (table && (!instance->decl || instance->decl->dimensions.empty()) &&
+            table->add(gateType, *instance, location.getIndex())) {
+            continue;
+        }
+
         if (!instance->decl) {
             results.append(createGate(compilation, scope, gateType, *instance, syntax.attributes));
         }
@@ -433,6 +442,87 @@ void GateArraySymbol::serializeTo(ASTSerializer& serializer) const {
     serializer.write("range", range.toString());
 }
 
+bool GateTable::add(GateType gateType, const GateInstanceSyntax& syntax, SymbolIndex index) {
+    auto gateIndex = uint32_t(gateTypes.size());
+    if (syntax.decl) {
+        auto name = syntax.decl->name.valueText();
+        if (!name.empty()) {
+            auto& nameMap = scope.getUnelaboratedNameMap();
+            if (nameMap.find(name) != nameMap.end() || !gatesByName.emplace(name, gateIndex).second)
+                return false;
+        }
+    }
+
+    gateTypes.push_back(gateType);
+    syntaxes.push_back(&syntax);
+    indices.push_back(index);
+    connectionOffsets.push_back(uint32_t(connections.size()));
+
+    for (auto expr : syntax.connections) {
+        // Only a bare identifier or a bit-select of one with
+        // a literal index get recorded as a connection to a net.
+        Connection conn;
+        if (expr->kind == SyntaxKind::IdentifierName) {
+            conn.net = getNetId(expr->as<IdentifierNameSyntax>().identifier.valueText());
+        }
+        else if (expr->kind == SyntaxKind::IdentifierSelectName) {
+            auto& isn = expr->as<IdentifierSelectNameSyntax>();
+            auto selector = isn.selectors.size() == 1 ? isn.selectors[0]->selector : nullptr;
+            if (selector && selector->kind == SyntaxKind::BitSelect) {
+                auto& bitExpr = *selector->as<BitSelectSyntax>().expr;
+                if (bitExpr.kind == SyntaxKind::IntegerLiteralExpression) {
+                    auto& literal = bitExpr.as<LiteralExpressionSyntax>().literal;
+                    auto bit = literal.intValue().as<int32_t>();
+                    if (bit && *bit != Connection::WholeNet) {
+                        conn.net = getNetId(isn.identifier.valueText());
+                        conn.bit = *bit;
+                    }
+                }
+            }
+        }
+        connections.push_back(conn);
+    }
+
+    return true;
+}
+
+string_view GateTable::getName(size_t index) const {
+    auto decl = syntaxes[index]->decl;
+    return decl ? decl->name.valueText() : ""sv;
+}
+
+span<const GateTable::Connection> GateTable::getConnections(size_t index) const {
+    size_t begin = connectionOffsets[index];
+    size_t end = index + 1 < connectionOffsets.size() ? connectionOffsets[index + 1]
+                                                      : connections.size();
+    return span<const Connection>(connections.data() + begin, end - begin);
+}
+
+const GateSymbol* GateTable::find(string_view name) const {
+    auto it = gatesByName.find(name);
+    if (it == gatesByName.end())
+        return nullptr;
+    return &getSymbol(it->second);
+}
+
+const GateSymbol& GateTable::getSymbol(size_t index) const {
+    auto& symbol = symbols[uint32_t(index)];
+    if (!symbol) {
+        auto gate = createGate(scope.getCompilation(), scope, gateTypes[index], *syntaxes[index],
+                               {});
+        gate->setParent(scope, indices[index]);
+        symbol = gate;
+    }
+    return *symbol;
+}
+
+uint32_t GateTable::getNetId(string_view name) {
+    auto [it, inserted] = netIds.emplace(name, uint32_t(netNames.size()));
+    if (inserted)
+        netNames.push_back(name);
+    return it->second;
+}
+
 ElabSystemTaskSymbol::ElabSystemTaskSymbol(ElabSystemTaskKind taskKind, SourceLocation loc) :
     Symbol(SymbolKind::ElabSystemTask, "", loc), taskKind(taskKind) {
 }
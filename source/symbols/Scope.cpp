@@ -376,16 +376,39 @@ void Scope::addMembers(const SyntaxNode& syntax) {
     }
 }
 
+const Symbol* Scope::findNameMapEntry(string_view name) const {
+    // Deferred members (instances, generate blocks, ports, enum values, etc) only
+    // ever add new names; if one of them collides with a name that's already in the
+    // map the existing entry wins and the collision is reported as a conflict. That
+    // means a hit here is final and we can skip elaborating the rest of the scope.
+    if (auto it = nameMap->find(name); it != nameMap->end()) {
+        if (deferredMemberIndex != DeferredMemberIndex::Invalid)
+            compilation.elabStats.lookupsWithoutElaboration++;
+        return it->second;
+    }
+
+    if (deferredMemberIndex != DeferredMemberIndex::Invalid) {
+        elaborate();
+        if (auto it = nameMap->find(name); it != nameMap->end())
+            return it->second;
+    }
+
+    // Gates kept in compact form aren't in the name map.
+    if (compilation.getOptions().compactGates) {
+        if (auto table = compilation.findGateTable(*this))
+            return table->find(name);
+    }
+    return nullptr;
+}
+
 const Symbol* Scope::find(string_view name) const {
     // Just do a simple lookup and return the result if we have one.
-    ensureElaborated();
-    auto it = nameMap->find(name);
-    if (it == nameMap->end())
+    const Symbol* symbol = findNameMapEntry(name);
+    if (!symbol)
         return nullptr;
 
     // Unwrap the symbol if it's a transparent member. Don't return imported
     // symbols; this function is for querying direct members only.
-    const Symbol* symbol = it->second;
     while (symbol->kind == SymbolKind::TransparentMember)
         symbol = &symbol->as<TransparentMemberSymbol>().wrapped;
 
@@ -412,6 +435,11 @@ span<const WildcardImportSymbol* const> Scope::getWildcardImports() const {
     return compilation.queryImports(importDataIndex);
 }
 
+const GateTable* Scope::getGateTable() const {
+    ensureElaborated();
+    return compilation.findGateTable(*this);
+}
+
 Scope::DeferredMemberData& Scope::getOrAddDeferredData() const {
     return compilation.getOrAddDeferredData(deferredMemberIndex);
 }
@@ -433,6 +461,8 @@ void Scope::insertMember(const Symbol* member, const Symbol* at, bool isElaborat
     if (!member->nextInScope)
         lastMember = member;
 
+    compilation.invalidateMemberIndex(*this);
+
     // Add to the name map if the symbol has a name, unless it's a port.
     // Per the spec, ports exist in their own namespaces.
     if (!member->name.empty() && member->kind != SymbolKind::Port &&
@@ -443,6 +473,28 @@ void Scope::insertMember(const Symbol* member, const Symbol* at, bool isElaborat
     }
 }
 
+void Scope::removeMembers(const flat_hash_set<const Symbol*>& toRemove) const {
+    const Symbol* prev = nullptr;
+    for (auto curr = firstMember; curr;) {
+        auto next = curr->nextInScope;
+        if (toRemove.find(curr) != toRemove.end()) {
+            if (prev)
+                prev->nextInScope = next;
+            else
+                firstMember = next;
+
+            curr->nextInScope = nullptr;
+        }
+        else {
+            prev = curr;
+        }
+        curr = next;
+    }
+
+    lastMember = prev;
+    compilation.invalidateMemberIndex(*this);
+}
+
 void Scope::handleNameConflict(const Symbol& member, const Symbol*& existing,
                                bool isElaborating) const {
     // We have a name collision; first check if this is ok (forwarding typedefs share a
@@ -585,6 +637,45 @@ void Scope::reportNameConflict(const Symbol& member, const Symbol& existing) con
     diag->addNote(diag::NotePreviousDefinition, existing.location);
 }
 
+span<const Symbol* const> Scope::membersOfKind(SymbolKind kind) const {
+    auto& index = getMemberIndex();
+    auto it = index.kindRanges.find(kind);
+    if (it == index.kindRanges.end())
+        return {};
+
+    auto [offset, count] = it->second;
+    return span<const Symbol* const>(index.byKind.data() + offset, count);
+}
+
+span<const Symbol* const> Scope::getMemberArray() const {
+    return getMemberIndex().members;
+}
+
+const Scope::MemberIndex& Scope::getMemberIndex() const {
+    ensureElaborated();
+
+    auto& index = compilation.getMemberIndex(*this);
+    if (index)
+        return *index;
+
+    index = std::make_unique<MemberIndex>();
+    for (auto member = firstMember; member; member = member->nextInScope)
+        index->members.push_back(member);
+
+    index->byKind = index->members;
+    std::stable_sort(index->byKind.begin(), index->byKind.end(),
+                     [](auto a, auto b) { return a->kind < b->kind; });
+
+    for (uint32_t i = 0; i < index->byKind.size(); i++) {
+        auto& range = index->kindRanges[index->byKind[i]->kind];
+        if (range.second == 0)
+            range.first = i;
+        range.second++;
+    }
+
+    return *index;
+}
+
 SymbolIndex Scope::getInsertionIndex(const Symbol& at) const {
     return SymbolIndex{ (uint32_t)at.indexInScope + (&at == lastMember) };
 }
@@ -593,6 +684,7 @@ void Scope::elaborate() const {
     ASSERT(deferredMemberIndex != DeferredMemberIndex::Invalid);
     auto deferredData = compilation.getOrAddDeferredData(deferredMemberIndex);
     deferredMemberIndex = DeferredMemberIndex::Invalid;
+    compilation.elabStats.scopesElaborated++;
 
     for (auto member : deferredData.getNameConflicts()) {
         auto existing = nameMap->find(member->name)->second;
@@ -647,10 +739,14 @@ void Scope::elaborate() const {
                 break;
             }
             case SyntaxKind::GateInstantiation: {
+                GateTable* table = nullptr;
+                if (compilation.getOptions().compactGates)
+                    table = &compilation.getOrAddGateTable(*this);
+
                 SmallVectorSized<const Symbol*, 8> instances;
                 LookupLocation location = LookupLocation::before(*symbol);
                 GateSymbol::fromSyntax(compilation, member.node.as<GateInstantiationSyntax>(),
-                                       location, *this, instances);
+                                       location, *this, instances, table);
                 insertMembers(instances, symbol);
                 break;
             }
@@ -831,6 +927,24 @@ void Scope::elaborate() const {
             addDiag(diag::UnresolvedForwardTypedef, symbol->location) << symbol->name;
     }
 
+    // Compact gates were checked against names that existed when they were added;
+    // anything elaborated after them could still collide.
+    if (auto table = compilation.findGateTable(*this)) {
+        for (size_t i = 0; i < table->size(); i++) {
+            auto name = table->getName(i);
+            if (name.empty())
+                continue;
+
+            if (auto it = nameMap->find(name); it != nameMap->end()) {
+                auto& gate = table->getSymbol(i);
+                if (gate.location < it->second->location)
+                    reportNameConflict(*it->second, gate);
+                else
+                    reportNameConflict(gate, *it->second);
+            }
+        }
+    }
+
     ASSERT(deferredMemberIndex == DeferredMemberIndex::Invalid);
 }
 
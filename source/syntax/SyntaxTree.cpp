@@ -6,6 +6,9 @@
 //------------------------------------------------------------------------------
 #include "slang/syntax/SyntaxTree.h"
 
+#include <atomic>
+#include <thread>
+
 #include "slang/parsing/Parser.h"
 #include "slang/parsing/Preprocessor.h"
 #include "slang/text/SourceManager.h"
@@ -20,6 +23,11 @@ SyntaxTree::SyntaxTree(SyntaxNode* root, SourceManager& sourceManager, BumpAlloc
         eof = parentTree->eof;
 }
 
+SyntaxTree::~SyntaxTree() {
+    if (!retainedBuffers.empty())
+        sourceMan.releaseBuffers(retainedBuffers);
+}
+
 std::shared_ptr<SyntaxTree> SyntaxTree::fromFile(string_view path) {
     return fromFile(path, getDefaultSourceManager());
 }
@@ -56,6 +64,155 @@ std::shared_ptr<SyntaxTree> SyntaxTree::fromBuffers(span<const SourceBuffer> buf
     return create(sourceManager, buffers, options, false);
 }
 
+std::shared_ptr<SyntaxTree> SyntaxTree::fromBuffersParallel(span<const SourceBuffer> buffers,
+                                                            SourceManager& sourceManager,
+                                                            const Bag& options,
+                                                            uint32_t numThreads) {
+    if (numThreads == 0)
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    const size_t numBuffers = buffers.size();
+    if (numBuffers < 2 || numThreads < 2)
+        return fromBuffers(buffers, sourceManager, options);
+
+    // First pass: scan each buffer in order for directives only, without parsing, and
+    // record the preprocessor state at the end of each one along with the trivia that
+    // will be carried over onto the first token of the next.
+    BumpAllocator alloc;
+    Diagnostics scratchDiags;
+    std::vector<std::unique_ptr<Preprocessor>> checkpoints;
+    std::vector<span<const Trivia>> carriedTrivia;
+    for (size_t i = 0; i < numBuffers; i++) {
+        auto pp = std::make_unique<Preprocessor>(sourceManager, alloc, scratchDiags, options);
+        if (i > 0) {
+            pp->copyStateFrom(*checkpoints.back());
+            pp->setSplitSource(carriedTrivia.back(), i == numBuffers - 1);
+        }
+        else {
+            pp->setSplitSource(std::nullopt, false);
+        }
+
+        pp->setRegisteredBuffers(buffers);
+        pp->setDirectivesOnly(true);
+        pp->pushSource(buffers[i]);
+
+        Token token;
+        do {
+            token = pp->next();
+        } while (token.kind != TokenKind::EndOfFile);
+
+        // Conditional blocks can't span files if we're going to split them up.
+        if (pp->hasOpenConditionals()) {
+            auto tree = fromBuffers(buffers, sourceManager, options);
+            for (auto& checkpoint : checkpoints)
+                tree->retainBuffers({}, checkpoint->getCreatedBuffers());
+            tree->retainBuffers({}, pp->getCreatedBuffers());
+            return tree;
+        }
+
+        carriedTrivia.push_back(token.trivia());
+        checkpoints.emplace_back(std::move(pp));
+    }
+
+    // Second pass: preprocess and parse each buffer in parallel.
+    struct FileResult {
+        BumpAllocator alloc;
+        Diagnostics diagnostics;
+        CompilationUnitSyntax* unit = nullptr;
+        optional<Parser::Metadata> metadata;
+        Token eof;
+        std::vector<BufferID> createdBuffers;
+    };
+
+    std::vector<FileResult> results(numBuffers);
+    std::atomic<size_t> nextIndex = 0;
+    auto worker = [&] {
+        while (true) {
+            size_t i = nextIndex++;
+            if (i >= numBuffers)
+                break;
+
+            auto& result = results[i];
+            Preprocessor preprocessor(sourceManager, result.alloc, result.diagnostics, options);
+            if (i > 0) {
+                preprocessor.copyStateFrom(*checkpoints[i - 1]);
+                preprocessor.setSplitSource(carriedTrivia[i - 1], i == numBuffers - 1);
+            }
+            else {
+                preprocessor.setSplitSource(std::nullopt, false);
+            }
+            preprocessor.pushSource(buffers[i]);
+
+            Parser parser(preprocessor, options);
+            result.unit = &parser.parseCompilationUnit();
+            result.metadata.emplace(parser.getMetadata());
+            result.eof = parser.getEOFToken();
+
+            auto created = preprocessor.getCreatedBuffers();
+            result.createdBuffers.assign(created.begin(), created.end());
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < std::min<size_t>(numThreads, numBuffers) - 1; i++)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+
+    // A buffer that doesn't parse cleanly on its own may have been relying on
+    // something from a neighboring buffer, so fall back to the serial path. The
+    // directives in the top-level buffers have already been registered with the
+    // source manager by the second pass, so don't register them again.
+    // Either way the resulting tree needs to hold on to whatever buffers the
+    // preprocessors created along the way, since macros defined in them can
+    // have ended up in the tree.
+    auto retainCreated = [&](SyntaxTree& tree) {
+        for (auto& checkpoint : checkpoints)
+            tree.retainBuffers({}, checkpoint->getCreatedBuffers());
+        for (auto& result : results)
+            tree.retainBuffers({}, result.createdBuffers);
+    };
+
+    for (auto& result : results) {
+        for (auto& diag : result.diagnostics) {
+            if (diag.isError()) {
+                auto tree = create(sourceManager, buffers, options, false, true);
+                retainCreated(*tree);
+                return tree;
+            }
+        }
+    }
+
+    // Stitch everything together into a single compilation unit.
+    SmallVectorSized<MemberSyntax*, 16> members;
+    Diagnostics diagnostics;
+    Parser::Metadata metadata;
+    for (auto& result : results) {
+        members.appendRange(result.unit->members);
+        diagnostics.appendRange(result.diagnostics);
+
+        for (auto& entry : result.metadata->nodeMap)
+            metadata.nodeMap.insert(entry);
+        for (auto name : result.metadata->globalInstances)
+            metadata.globalInstances.insert(name);
+        metadata.bindDirectives.appendRange(result.metadata->bindDirectives);
+
+        alloc.steal(std::move(result.alloc));
+    }
+
+    SyntaxFactory factory(alloc);
+    Token eof = results.back().eof;
+    auto root = &factory.compilationUnit(members.copy(alloc), eof);
+
+    auto tree = std::shared_ptr<SyntaxTree>(new SyntaxTree(root, sourceManager, std::move(alloc),
+                                                           std::move(diagnostics),
+                                                           std::move(metadata), options, eof));
+    tree->retainBuffers(buffers, {});
+    retainCreated(*tree);
+    return tree;
+}
+
 SourceManager& SyntaxTree::getDefaultSourceManager() {
     static SourceManager instance;
     return instance;
@@ -71,10 +228,12 @@ SyntaxTree::SyntaxTree(SyntaxNode* root, SourceManager& sourceManager, BumpAlloc
 
 std::shared_ptr<SyntaxTree> SyntaxTree::create(SourceManager& sourceManager,
                                                span<const SourceBuffer> sources, const Bag& options,
-                                               bool guess) {
+                                               bool guess, bool directivesRegistered) {
     BumpAllocator alloc;
     Diagnostics diagnostics;
     Preprocessor preprocessor(sourceManager, alloc, diagnostics, options);
+    if (directivesRegistered)
+        preprocessor.setRegisteredBuffers(sources);
 
     for (auto it = sources.rbegin(); it != sources.rend(); it++)
         preprocessor.pushSource(*it);
@@ -85,14 +244,41 @@ std::shared_ptr<SyntaxTree> SyntaxTree::create(SourceManager& sourceManager,
     if (!guess)
         root = &parser.parseCompilationUnit();
     else {
-        root = &parser.parseGuess();
-        if (!parser.isDone())
-            return create(sourceManager, sources, options, false);
+        // Cancellation can interrupt the guessed parse anywhere it reaches a member
+        // list; fall back to the compilation unit path, which turns it into an empty unit.
+        bool cancelled = false;
+        try {
+            root = &parser.parseGuess();
+        }
+        catch (const Parser::CancelledException&) {
+            cancelled = true;
+        }
+
+        if (cancelled || !parser.isDone()) {
+            auto tree = create(sourceManager, sources, options, false);
+            tree->retainBuffers({}, preprocessor.getCreatedBuffers());
+            return tree;
+        }
     }
 
-    return std::shared_ptr<SyntaxTree>(new SyntaxTree(root, sourceManager, std::move(alloc),
-                                                      std::move(diagnostics), parser.getMetadata(),
-                                                      options, parser.getEOFToken()));
+    auto tree = std::shared_ptr<SyntaxTree>(new SyntaxTree(root, sourceManager, std::move(alloc),
+                                                           std::move(diagnostics),
+                                                           parser.getMetadata(), options,
+                                                           parser.getEOFToken()));
+    tree->retainBuffers(sources, preprocessor.getCreatedBuffers());
+    return tree;
+}
+
+void SyntaxTree::retainBuffers(span<const SourceBuffer> sources, span<const BufferID> created) {
+    if (!sourceMan.isBufferEvictionEnabled())
+        return;
+
+    size_t start = retainedBuffers.size();
+    for (auto& source : sources)
+        retainedBuffers.push_back(source.id);
+    retainedBuffers.insert(retainedBuffers.end(), created.begin(), created.end());
+
+    sourceMan.retainBuffers(span<const BufferID>(retainedBuffers).subspan(start));
 }
 
 } // namespace slang
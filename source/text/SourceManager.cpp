@@ -10,7 +10,10 @@
 #    include <sys/stat.h>
 #endif
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <stdexcept>
 #include <string>
 
 #include "slang/util/StackContainer.h"
@@ -18,12 +21,33 @@
 
 namespace slang {
 
+// Gets the name to report for a file loaded from disk: relative to the
+// current directory if possible, otherwise just the file name.
+static std::string getDisplayName(const fs::path& path) {
+    std::error_code ec;
+    fs::path rel = fs::proximate(path, ec);
+    if (ec || rel.empty())
+        return path.filename().u8string();
+    return rel.u8string();
+}
+
 SourceManager::SourceManager() {
     // add a dummy entry to the start of the directory list so that our file IDs line up
     FileInfo file;
     bufferEntries.emplace_back(file);
 }
 
+SourceManager::~SourceManager() {
+    {
+        std::unique_lock lock(prefetchMutex);
+        prefetchStopping = true;
+    }
+
+    prefetchCv.notify_all();
+    if (prefetchThread.joinable())
+        prefetchThread.join();
+}
+
 std::string SourceManager::makeAbsolutePath(string_view path) const {
     return fs::canonical(path).string();
 }
@@ -64,8 +88,8 @@ size_t SourceManager::getColumnNumber(SourceLocation location) const {
     // walk backward to find start of line
     auto fd = info->data;
     size_t lineStart = location.offset();
-    ASSERT(lineStart < fd->mem.size());
-    while (lineStart > 0 && fd->mem[lineStart - 1] != '\n' && fd->mem[lineStart - 1] != '\r')
+    ASSERT(lineStart < fd->text.size());
+    while (lineStart > 0 && fd->text[lineStart - 1] != '\n' && fd->text[lineStart - 1] != '\r')
         lineStart--;
 
     return location.offset() - lineStart + 1;
@@ -271,15 +295,16 @@ string_view SourceManager::getSourceText(BufferID buffer) const {
 
     // LOCKING: not required here, data is immutable after creation
     auto fd = info->data;
-    return string_view(fd->mem.data(), fd->mem.size());
+    return fd->text;
 }
 
 SourceLocation SourceManager::createExpansionLoc(SourceLocation originalLoc,
                                                  SourceRange expansionRange, bool isMacroArg) {
     std::unique_lock lock(mut);
 
-    bufferEntries.emplace_back(ExpansionInfo(originalLoc, expansionRange, isMacroArg));
-    return SourceLocation(BufferID((uint32_t)(bufferEntries.size() - 1), ""sv), 0);
+    uint32_t id = addEntry(ExpansionInfo(originalLoc, expansionRange, isMacroArg),
+                           isMacroArg ? originalLoc : expansionRange.start());
+    return SourceLocation(BufferID(id, ""sv), 0);
 }
 
 SourceLocation SourceManager::createExpansionLoc(SourceLocation originalLoc,
@@ -287,8 +312,9 @@ SourceLocation SourceManager::createExpansionLoc(SourceLocation originalLoc,
                                                  string_view macroName) {
     std::unique_lock lock(mut);
 
-    bufferEntries.emplace_back(ExpansionInfo(originalLoc, expansionRange, macroName));
-    return SourceLocation(BufferID((uint32_t)(bufferEntries.size() - 1), macroName), 0);
+    uint32_t id = addEntry(ExpansionInfo(originalLoc, expansionRange, macroName),
+                           expansionRange.start());
+    return SourceLocation(BufferID(id, macroName), 0);
 }
 
 SourceBuffer SourceManager::assignText(string_view text, SourceLocation includedFrom) {
@@ -305,21 +331,46 @@ SourceBuffer SourceManager::assignText(string_view path, string_view text,
     }
 
     std::vector<char> buffer;
+    buffer.reserve(text.size() + 1);
     buffer.insert(buffer.end(), text.begin(), text.end());
-    if (buffer.empty() || buffer.back() != '\0')
-        buffer.push_back('\0');
 
     return assignBuffer(path, std::move(buffer), includedFrom);
 }
 
 SourceBuffer SourceManager::assignBuffer(string_view path, std::vector<char>&& buffer,
                                          SourceLocation includedFrom) {
+    if (buffer.empty() || buffer.back() != '\0')
+        buffer.push_back('\0');
+
+    return addUserBuffer(std::make_unique<FileData>(nullptr, std::string(path), std::move(buffer)),
+                         includedFrom);
+}
+
+SourceBuffer SourceManager::assignExternalText(string_view path, string_view text,
+                                               std::shared_ptr<const void> owner,
+                                               SourceLocation includedFrom) {
+    if (text.empty() || text.back() != '\0')
+        throw std::invalid_argument("External source text must be null terminated");
+
+    std::string temp;
+    if (path.empty()) {
+        using namespace std::literals;
+        temp = "<unnamed_buffer"s + std::to_string(unnamedBufferCount++) + ">"s;
+        path = temp;
+    }
+
+    return addUserBuffer(std::make_unique<FileData>(std::string(path), text, std::move(owner)),
+                         includedFrom);
+}
+
+SourceBuffer SourceManager::addUserBuffer(std::unique_ptr<FileData> fd,
+                                          SourceLocation includedFrom) {
     std::unique_lock lock(mut);
-    userFileBuffers.emplace_back(FileData(nullptr, std::string(path), std::move(buffer)));
 
-    FileData* fd = &userFileBuffers.back();
-    userFileLookup[std::string(path)] = fd;
-    return createBufferEntry(fd, includedFrom, lock);
+    FileData* fdPtr = fd.get();
+    userFileBuffers.emplace(fdPtr, std::move(fd));
+    userFileLookup[fdPtr->name] = fdPtr;
+    return createBufferEntry(fdPtr, includedFrom, lock);
 }
 
 SourceBuffer SourceManager::readSource(string_view path) {
@@ -381,6 +432,66 @@ SourceBuffer SourceManager::readHeader(string_view path, SourceLocation included
     return SourceBuffer();
 }
 
+void SourceManager::setBufferEviction(bool enabled) {
+    std::unique_lock lock(mut);
+    evictionEnabled = enabled;
+}
+
+void SourceManager::retainBuffers(span<const BufferID> buffers) {
+    std::unique_lock lock(mut);
+    for (auto buffer : buffers) {
+        // Only root buffers are reference counted; everything else lives
+        // as long as the root that owns it.
+        uint32_t id = buffer.getId();
+        if (id < entryRoots.size() && entryRoots[id] == id)
+            rootRefCounts[id]++;
+    }
+}
+
+void SourceManager::releaseBuffers(span<const BufferID> buffers) {
+    std::unique_lock lock(mut);
+    for (auto buffer : buffers) {
+        auto it = rootRefCounts.find(buffer.getId());
+        if (it == rootRefCounts.end() || --it->second > 0)
+            continue;
+
+        uint32_t root = it->first;
+        rootRefCounts.erase(it);
+
+        if (auto owned = ownedEntries.find(root); owned != ownedEntries.end()) {
+            for (auto id : owned->second)
+                freeEntry(id);
+            ownedEntries.erase(owned);
+        }
+        freeEntry(root);
+
+        // Drop anything prefetched for this root that never got used.
+        if (auto prefetched = prefetchedFiles.find(root); prefetched != prefetchedFiles.end()) {
+            for (auto& key : prefetched->second) {
+                auto cached = lookupCache.find(key);
+                if (cached != lookupCache.end() && cached->second && !cached->second->refCount)
+                    lookupCache.erase(cached);
+            }
+            prefetchedFiles.erase(prefetched);
+        }
+    }
+}
+
+std::vector<std::string> SourceManager::getLoadedFiles() const {
+    std::vector<std::string> results;
+    {
+        std::shared_lock lock(mut);
+        for (auto& [path, fd] : lookupCache) {
+            // Files with no buffers referencing them were prefetched and never used.
+            if (fd && fd->refCount)
+                results.push_back(path);
+        }
+    }
+
+    std::sort(results.begin(), results.end());
+    return results;
+}
+
 void SourceManager::addLineDirective(SourceLocation location, size_t lineNum, string_view name,
                                      uint8_t level) {
     SourceLocation fileLocation = getFullyExpandedLoc(location);
@@ -444,9 +555,66 @@ const SourceManager::FileInfo* SourceManager::getFileInfo(BufferID buffer) const
 SourceBuffer SourceManager::createBufferEntry(FileData* fd, SourceLocation includedFrom,
                                               std::unique_lock<std::shared_mutex>&) {
     ASSERT(fd);
-    bufferEntries.emplace_back(FileInfo(fd, includedFrom));
-    return SourceBuffer{ string_view(fd->mem.data(), fd->mem.size()),
-                         BufferID((uint32_t)(bufferEntries.size() - 1), fd->name) };
+    fd->refCount++;
+
+    uint32_t id = addEntry(FileInfo(fd, includedFrom), includedFrom);
+    return SourceBuffer{ fd->text, BufferID(id, fd->name) };
+}
+
+uint32_t SourceManager::addEntry(std::variant<FileInfo, ExpansionInfo>&& entry,
+                                 SourceLocation owner) {
+    uint32_t id;
+    if (!freeEntries.empty()) {
+        id = freeEntries.back();
+        freeEntries.pop_back();
+        bufferEntries[id] = std::move(entry);
+    }
+    else {
+        id = (uint32_t)bufferEntries.size();
+        bufferEntries.emplace_back(std::move(entry));
+    }
+
+    if (evictionEnabled) {
+        // An entry created from a location inside some other buffer belongs to
+        // that buffer's root. If that buffer is never freed, neither is this one.
+        uint32_t root = id;
+        uint32_t ownerId = owner.buffer().getId();
+        if (owner.buffer() && ownerId < bufferEntries.size())
+            root = ownerId < entryRoots.size() ? entryRoots[ownerId] : 0;
+
+        if (entryRoots.size() <= id)
+            entryRoots.resize(id + 1);
+
+        entryRoots[id] = root;
+        if (root && root != id)
+            ownedEntries[root].push_back(id);
+    }
+
+    return id;
+}
+
+void SourceManager::freeEntry(uint32_t id) {
+    if (auto info = std::get_if<FileInfo>(&bufferEntries[id]); info && info->data) {
+        FileData* fd = info->data;
+        if (--fd->refCount == 0) {
+            if (fd->cacheKey) {
+                std::string key = *fd->cacheKey;
+                lookupCache.erase(key);
+            }
+            else {
+                if (auto it = userFileLookup.find(fd->name);
+                    it != userFileLookup.end() && it->second == fd) {
+                    userFileLookup.erase(it);
+                }
+                userFileBuffers.erase(fd);
+            }
+        }
+    }
+
+    bufferEntries[id] = FileInfo();
+    entryRoots[id] = 0;
+    diagDirectives.erase(BufferID(id, ""sv));
+    freeEntries.push_back(id);
 }
 
 SourceBuffer SourceManager::openCached(const fs::path& fullPath, SourceLocation includedFrom) {
@@ -480,25 +648,177 @@ SourceBuffer SourceManager::openCached(const fs::path& fullPath, SourceLocation
 
 SourceBuffer SourceManager::cacheBuffer(const fs::path& path, SourceLocation includedFrom,
                                         std::vector<char>&& buffer) {
-    std::string name;
-    std::error_code ec;
-    fs::path rel = fs::proximate(path, ec);
-    if (ec || rel.empty())
-        name = path.filename().u8string();
-    else
-        name = rel.u8string();
+    std::string name = getDisplayName(path);
 
     std::unique_lock lock(mut);
+    FileData* fd = addCachedData(path, std::move(name), std::move(buffer), lock);
+    return createBufferEntry(fd, includedFrom, lock);
+}
 
+SourceManager::FileData* SourceManager::addCachedData(const fs::path& path, std::string&& name,
+                                                      std::vector<char>&& buffer,
+                                                      std::unique_lock<std::shared_mutex>&) {
     auto fd = std::make_unique<FileData>(&*directories.insert(path.parent_path()).first,
                                          std::move(name), std::move(buffer));
 
-    FileData* fdPtr = lookupCache.emplace(path.u8string(), std::move(fd)).first->second.get();
-    return createBufferEntry(fdPtr, includedFrom, lock);
+    // Someone else may have loaded the file in the meantime, in which case we use
+    // their copy, or may have failed to load it, in which case we replace the entry.
+    auto [it, inserted] = lookupCache.emplace(path.u8string(), nullptr);
+    if (!it->second) {
+        it->second = std::move(fd);
+        it->second->cacheKey = &it->first;
+    }
+
+    return it->second.get();
+}
+
+void SourceManager::prefetchIncludes(SourceBuffer buffer) {
+    // Other threads may be adding buffers (which can move the entry we're
+    // looking at) or evicting file data, so read everything under the lock.
+    const fs::path* directory = nullptr;
+    uint32_t owner = 0;
+    if (buffer.id) {
+        std::shared_lock lock(mut);
+        ASSERT(buffer.id.getId() < bufferEntries.size());
+        auto info = std::get_if<FileInfo>(&bufferEntries[buffer.id.getId()]);
+        if (info && info->data)
+            directory = info->data->directory;
+
+        if (buffer.id.getId() < entryRoots.size())
+            owner = entryRoots[buffer.id.getId()];
+    }
+
+    queueIncludes(buffer.data, directory, owner);
+}
+
+void SourceManager::waitForPrefetch() {
+    std::unique_lock lock(prefetchMutex);
+    prefetchCv.wait(lock, [this] { return prefetchQueue.empty() && !prefetchBusy; });
+}
+
+void SourceManager::queueIncludes(string_view text, const fs::path* directory,
+                                  uint32_t owner) {
+    // Look for `include followed by a quoted or angle bracketed path on the same line.
+    std::vector<PrefetchRequest> requests;
+    const char* ptr = text.data();
+    const char* end = ptr + text.size();
+    while ((ptr = (const char*)memchr(ptr, '`', size_t(end - ptr))) != nullptr) {
+        ptr++;
+        if (size_t(end - ptr) < 7 || memcmp(ptr, "include", 7) != 0)
+            continue;
+
+        ptr += 7;
+        while (ptr != end && (*ptr == ' ' || *ptr == '\t'))
+            ptr++;
+
+        if (ptr == end || (*ptr != '"' && *ptr != '<'))
+            continue;
+
+        char close = *ptr == '"' ? '"' : '>';
+        const char* start = ++ptr;
+        while (ptr != end && *ptr != close && *ptr != '\n' && *ptr != '\r' && *ptr != '\0')
+            ptr++;
+
+        if (ptr != end && *ptr == close && ptr != start)
+            requests.push_back({ std::string(start, ptr), directory, owner, close == '>' });
+    }
+
+    if (requests.empty())
+        return;
+
+    std::unique_lock lock(prefetchMutex);
+    if (prefetchStopping)
+        return;
+
+    for (auto& request : requests)
+        prefetchQueue.emplace_back(std::move(request));
+
+    if (!prefetchThread.joinable())
+        prefetchThread = std::thread([this] { prefetchMain(); });
+    prefetchCv.notify_all();
+}
+
+void SourceManager::prefetchMain() {
+    std::unique_lock lock(prefetchMutex);
+    while (true) {
+        prefetchCv.wait(lock, [this] { return prefetchStopping || !prefetchQueue.empty(); });
+        if (prefetchStopping)
+            return;
+
+        PrefetchRequest request = std::move(prefetchQueue.front());
+        prefetchQueue.pop_front();
+        prefetchBusy = true;
+
+        lock.unlock();
+        prefetchHeader(request);
+        lock.lock();
+
+        prefetchBusy = false;
+        prefetchCv.notify_all();
+    }
+}
+
+void SourceManager::prefetchHeader(const PrefetchRequest& request) {
+    // Search the same places readHeader() would, in the same order.
+    fs::path p = widen(request.path);
+    if (p.is_absolute()) {
+        prefetchFile(p, request.owner);
+        return;
+    }
+
+    std::vector<fs::path> dirs;
+    {
+        std::shared_lock lock(mut);
+        if (request.isSystemPath)
+            dirs = systemDirectories;
+        else {
+            if (request.directory)
+                dirs.push_back(*request.directory);
+            dirs.insert(dirs.end(), userDirectories.begin(), userDirectories.end());
+        }
+    }
+
+    for (auto& d : dirs) {
+        if (prefetchFile(d / p, request.owner))
+            return;
+    }
+}
+
+bool SourceManager::prefetchFile(const fs::path& fullPath, uint32_t owner) {
+    std::error_code ec;
+    fs::path absPath = fs::canonical(fullPath, ec);
+    if (ec)
+        return false;
+
+    {
+        std::shared_lock lock(mut);
+        if (auto it = lookupCache.find(absPath.u8string()); it != lookupCache.end())
+            return it->second != nullptr;
+    }
+
+    std::vector<char> buffer;
+    if (!readFile(absPath, buffer))
+        return false;
+
+    std::string name = getDisplayName(absPath);
+
+    std::unique_lock lock(mut);
+    if (owner) {
+        // If the buffer that asked for this has already been released there's
+        // no one left to free the file later, so don't keep it around.
+        if (owner >= entryRoots.size() || entryRoots[owner] != owner)
+            return true;
+        prefetchedFiles[owner].push_back(absPath.u8string());
+    }
+
+    // Keep holding the lock while scanning the new file for includes of
+    // its own so that it can't be evicted out from under us.
+    FileData* fd = addCachedData(absPath, std::move(name), std::move(buffer), lock);
+    queueIncludes(fd->text, fd->directory, owner);
+    return true;
 }
 
-void SourceManager::computeLineOffsets(const std::vector<char>& buffer,
-                                       std::vector<size_t>& offsets) noexcept {
+void SourceManager::computeLineOffsets(string_view buffer, std::vector<size_t>& offsets) noexcept {
     // first line always starts at offset 0
     offsets.push_back(0);
 
@@ -582,7 +902,7 @@ size_t SourceManager::getRawLineNumber(SourceLocation location) const {
         readLock.unlock();
 
         std::unique_lock writeLock(mut);
-        computeLineOffsets(fd->mem, fd->lineOffsets);
+        computeLineOffsets(fd->text, fd->lineOffsets);
 
         writeLock.unlock();
         readLock.lock();
@@ -979,7 +979,7 @@ const Type& Type::getPredefinedType(Compilation& compilation, SyntaxKind kind, b
 
 Diagnostic& operator<<(Diagnostic& diag, const Type& arg) {
     ASSERT(!arg.isError());
-    diag.args.emplace_back(&arg);
+    diag.addArg(std::any(&arg));
     return diag;
 }
 
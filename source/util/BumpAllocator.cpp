@@ -25,7 +25,8 @@ BumpAllocator::~BumpAllocator() {
 }
 
 BumpAllocator::BumpAllocator(BumpAllocator&& other) noexcept :
-    head(std::exchange(other.head, nullptr)), endPtr(other.endPtr) {
+    head(std::exchange(other.head, nullptr)), endPtr(other.endPtr),
+    bytesAllocated(std::exchange(other.bytesAllocated, 0)), byteLimit(other.byteLimit) {
 }
 
 BumpAllocator& BumpAllocator::operator=(BumpAllocator&& other) noexcept {
@@ -46,6 +47,7 @@ void BumpAllocator::steal(BumpAllocator&& other) {
 
     seg->prev = head->prev;
     head->prev = std::exchange(other.head, nullptr);
+    bytesAllocated += std::exchange(other.bytesAllocated, 0);
 }
 
 byte* BumpAllocator::allocateSlow(size_t size, size_t alignment) {
@@ -64,6 +66,7 @@ byte* BumpAllocator::allocateSlow(size_t size, size_t alignment) {
 
 BumpAllocator::Segment* BumpAllocator::allocSegment(Segment* prev, size_t size) {
     auto seg = (Segment*)malloc(size);
+    bytesAllocated += size;
     seg->prev = prev;
     seg->current = (byte*)seg + sizeof(Segment);
     return seg;
@@ -6,10 +6,16 @@
 //------------------------------------------------------------------------------
 #include "slang/util/OS.h"
 
+#include <fstream>
+
 #if defined(_MSC_VER)
+#    include <Windows.h>
 #    include <fcntl.h>
 #    include <io.h>
 #else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
 #    include <unistd.h>
 #endif
 
@@ -41,4 +47,113 @@ bool OS::fileSupportsColors(FILE* file) {
 
 #endif
 
+MappedFile::~MappedFile() {
+    close();
+}
+
+#if defined(_MSC_VER)
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    HANDLE file = CreateFileW(widen(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    size = size_t(fileSize.QuadPart);
+    if (size == 0) {
+        CloseHandle(file);
+        return true;
+    }
+
+    mappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mappingHandle)
+        return false;
+
+    data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (!data) {
+        close();
+        return false;
+    }
+
+    mapped = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (mapped)
+        UnmapViewOfFile(data);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+
+    mappingHandle = nullptr;
+    data = nullptr;
+    size = 0;
+    mapped = false;
+    fallback.clear();
+}
+
+#else
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat s;
+    if (::fstat(fd, &s) != 0 || s.st_size < 0) {
+        ::close(fd);
+        return false;
+    }
+
+    size = size_t(s.st_size);
+    if (size == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    void* ptr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (ptr != MAP_FAILED) {
+        data = static_cast<const char*>(ptr);
+        mapped = true;
+        return true;
+    }
+
+    // Some files (pipes, special filesystems) can't be mapped;
+    // fall back to reading them into memory.
+    std::ifstream stream(path, std::ios::binary);
+    fallback.resize(size);
+    if (!stream.read(fallback.data(), (std::streamsize)size)) {
+        close();
+        return false;
+    }
+
+    data = fallback.data();
+    return true;
+}
+
+void MappedFile::close() {
+    if (mapped)
+        ::munmap(const_cast<char*>(data), size);
+
+    data = nullptr;
+    size = 0;
+    mapped = false;
+    fallback.clear();
+}
+
+#endif
+
 } // namespace slang
@@ -487,6 +487,30 @@ TEST_CASE("DiagnosticEngine::setWarningOptions") {
     CHECK(msg == "warning: unknown warning option '-Wasdf' [-Wunknown-warning-option]\n");
 }
 
+TEST_CASE("Diagnostic copies share argument storage") {
+    Diagnostic diag(diag::ExpectedIdentifier, SourceLocation::NoLocation);
+    CHECK(diag.args().empty());
+    CHECK(diag.ranges().empty());
+    CHECK(diag.notes().empty());
+
+    diag << "foo"s << 42;
+    diag.addNote(diag::NoteDeclarationHere, SourceLocation(BufferID(1, ""), 0));
+
+    Diagnostic copy = diag;
+    CHECK(copy.sharesStorageWith(diag));
+    CHECK(copy.args().data() == diag.args().data());
+    CHECK(copy.notes().size() == 1);
+
+    // Modifying the copy clones the storage and leaves the original alone.
+    copy << "bar"s;
+    CHECK(!copy.sharesStorageWith(diag));
+    CHECK(copy.args().size() == 3);
+    CHECK(diag.args().size() == 2);
+    CHECK(std::get<std::string>(diag.args()[0]) == "foo");
+    CHECK(std::get<std::string>(copy.args()[2]) == "bar");
+    CHECK(copy.notes().size() == 1);
+}
+
 TEST_CASE("Diagnostic Pragmas") {
     auto tree = SyntaxTree::fromText(R"(
 module m;
@@ -533,3 +557,47 @@ source:11:5: warning: extra ';' has no effect [-Wempty-member]
     ^
 )");
 }
+
+TEST_CASE("Diagnostic Pragmas with many regions") {
+    // Generated code often toggles warnings around every block.
+    std::string text = "module m;\n";
+    for (int i = 0; i < 200; i++) {
+        text += "`pragma diagnostic push\n";
+        text += i % 2 ? "`pragma diagnostic error=\"-Wempty-member\"\n"
+                      : "`pragma diagnostic ignore=\"-Wempty-member\"\n";
+        text += "    ;\n";
+        text += "`pragma diagnostic pop\n";
+        text += "    ;\n";
+    }
+    text += "endmodule\n";
+
+    auto tree = SyntaxTree::fromText(text);
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+
+    // Setting the mappings again should replace them rather than add to them.
+    DiagnosticEngine engine(tree->sourceManager());
+    engine.setMappingsFromPragmas();
+    engine.setMappingsFromPragmas();
+
+    size_t ignored = 0, errors = 0, warnings = 0;
+    for (auto& diag : compilation.getAllDiagnostics()) {
+        switch (engine.getSeverity(diag.code, diag.location)) {
+            case DiagnosticSeverity::Ignored:
+                ignored++;
+                break;
+            case DiagnosticSeverity::Error:
+                errors++;
+                break;
+            case DiagnosticSeverity::Warning:
+                warnings++;
+                break;
+            default:
+                break;
+        }
+    }
+
+    CHECK(ignored == 100);
+    CHECK(errors == 100);
+    CHECK(warnings == 200);
+}
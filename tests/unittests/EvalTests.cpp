@@ -2085,3 +2085,135 @@ TEST_CASE("Array locator methods") {
 
     NO_SESSION_ERRORS;
 }
+
+TEST_CASE("Eval $readmemh / $readmemb") {
+    ScriptSession session;
+    session.eval("logic [31:0] mem [8];");
+    session.eval("$readmemh(\"" + findTestDir() + "mem.hex\", mem);");
+
+    CHECK(session.eval("mem[2]").integer() == 0xdeadbeef);
+    CHECK(session.eval("mem[3]").integer() == 1);
+    CHECK(session.eval("mem[4]").integer() == 0x1234abcd);
+    CHECK(session.eval("mem[5]").integer().hasUnknown());
+    CHECK(session.eval("mem[6]").integer() == 0xcafef00d);
+    CHECK(session.eval("mem[0]").integer().hasUnknown());
+
+    session.eval("bit [7:0] bmem [3:0];");
+    session.eval("$readmemb(\"" + findTestDir() + "mem.bin\", bmem, 3, 1);");
+    CHECK(session.eval("bmem[3]").integer() == 0xaa);
+    CHECK(session.eval("bmem[2]").integer() == 0xf0);
+    CHECK(session.eval("bmem[1]").integer() == 0);
+
+    session.eval("logic [7:0] amem [int];");
+    session.eval("$readmemh(\"" + findTestDir() + "mem.hex\", amem);");
+    CHECK(session.eval("amem.num()").integer() == 5);
+    CHECK(session.eval("amem[6]").integer() == 0x0d);
+
+    session.eval(R"(
+function automatic logic [31:0] lookup(int i);
+    logic [31:0] rom [8];
+    $readmemh(")" + findTestDir() + R"(mem.hex", rom);
+    return rom[i];
+endfunction
+)");
+    CHECK(session.eval("lookup(4)").integer() == 0x1234abcd);
+
+    NO_SESSION_ERRORS;
+
+    session.eval("$readmemb(\"" + findTestDir() + "mem.hex\", mem);");
+    auto diags = session.getDiagnostics();
+    REQUIRE(diags.size() == 1);
+    CHECK(diags[0].code == diag::ConstEvalReadMemFailed);
+}
+
+TEST_CASE("Loop-invariant caching in constant functions") {
+    auto tree = SyntaxTree::fromText(R"(
+module m;
+    localparam int W = 8;
+
+    function automatic int f(int n, int k);
+        int t[16];
+        int sum = 0;
+        for (int i = 0; i < n; i++) begin
+            t[i] = i ^ ((W - 1) * k);
+            sum += t[i] + (k << 2);
+        end
+        return sum;
+    endfunction
+
+    function automatic int g(int n);
+        int x = 1, acc = 0;
+        while (n > 0) begin
+            acc += x * 2;
+            x++;
+            n--;
+        end
+        return acc;
+    endfunction
+
+    localparam int P = f(16, 3);
+    localparam int Q = g(4);
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+
+    auto& m = compilation.getRoot().topInstances[0]->body;
+    CHECK(m.find<ParameterSymbol>("P").getValue().integer() == 568);
+    CHECK(m.find<ParameterSymbol>("Q").getValue().integer() == 20);
+
+    // Evaluate a fresh call, since the parameter initializers have already been
+    // cached. Both (W - 1) * k and k << 2 are computed once and then reused for
+    // the remaining 15 iterations.
+    auto call = SyntaxTree::fromText("f(16, 3)");
+    auto& expr = Expression::bind(call->root().as<ExpressionSyntax>(),
+                                  BindContext(m, LookupLocation::max));
+
+    EvalContext ctx(compilation);
+    CHECK(expr.eval(ctx).integer() == 568);
+    CHECK(ctx.getLoopInvariantHits() == 30);
+}
+
+TEST_CASE("String building in constant functions") {
+    auto tree = SyntaxTree::fromText(R"(
+module m;
+    function automatic string build(int n);
+        string s = "";
+        for (int i = 0; i < n; i++)
+            s = {s, "x"};
+        return s;
+    endfunction
+
+    function automatic string branch;
+        string a = "ab";
+        string b = {a, "c"};
+        string c = {a, "d"};
+        a = {a, a};
+        return {a, "-", b, "-", c};
+    endfunction
+
+    localparam string S = build(100000);
+    localparam string T = branch();
+endmodule
+)");
+
+    CompilationOptions co;
+    co.maxConstexprSteps = 1000000;
+
+    Bag options;
+    options.set(co);
+
+    Compilation compilation(options);
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+
+    auto& m = compilation.getRoot().topInstances[0]->body;
+    auto s = m.find<ParameterSymbol>("S").getValue().str();
+    CHECK(s.size() == 100000);
+    CHECK(s.find_first_not_of('x') == std::string::npos);
+
+    // Strings that share a buffer must not see each other's appends.
+    CHECK(m.find<ParameterSymbol>("T").getValue().str() == "abab-abc-abd");
+}
@@ -1,7 +1,9 @@
 #include "Test.h"
 
 #include "slang/compilation/Compilation.h"
+#include "slang/symbols/ASTSerializer.h"
 #include "slang/syntax/SyntaxTree.h"
+#include "slang/text/Json.h"
 
 SVInt testParameter(const std::string& text, uint32_t index = 0) {
     const auto& fullText = "module Top; " + text + " endmodule";
@@ -1982,3 +1984,101 @@ endmodule
     compilation.addSyntaxTree(tree);
     NO_COMPILATION_ERRORS;
 }
+
+TEST_CASE("Bind-time constant folding") {
+    auto tree = SyntaxTree::fromText(R"(
+module m #(parameter int W = 8);
+    typedef enum { A = 2, B = A * 3 } e_t;
+    localparam int P = (W * 4 - 1) >> 1;
+    localparam real R = W / 2.0 + 1;
+    logic [W-1:0] v;
+    int i;
+    initial i = v + (W << 2);
+endmodule
+)");
+
+    auto compile = [&](bool fold) {
+        CompilationOptions co;
+        co.foldConstants = fold;
+
+        Bag options;
+        options.set(co);
+
+        auto compilation = std::make_unique<Compilation>(options);
+        compilation->addSyntaxTree(tree);
+        return compilation;
+    };
+
+    auto folded = compile(true);
+    auto unfolded = compile(false);
+
+    auto getJson = [](Compilation& compilation) {
+        JsonWriter writer;
+        ASTSerializer serializer(compilation, writer);
+        serializer.setIncludeAddresses(false);
+        serializer.serialize(compilation.getRoot());
+        return std::string(writer.view());
+    };
+
+    // Output is identical whether or not folding is enabled.
+    CHECK(getJson(*folded) == getJson(*unfolded));
+    CHECK(folded->getAllDiagnostics().empty());
+
+    auto& root = folded->getRoot();
+    auto& p = root.lookupName<ParameterSymbol>("m.P");
+    CHECK(p.getValue().integer() == 15);
+
+    auto init = p.getInitializer();
+    REQUIRE(init);
+    REQUIRE(init->kind == ExpressionKind::IntegerLiteral);
+    CHECK(init->as<IntegerLiteral>().foldedFrom);
+    CHECK(init->sourceRange.start() == init->as<IntegerLiteral>().foldedFrom->sourceRange.start());
+
+    CHECK(root.lookupName<ParameterSymbol>("m.R").getValue().real() == 5.0);
+
+    auto& b = root.lookupName<EnumValueSymbol>("m.B");
+    CHECK(b.getValue().integer() == 6);
+
+    // The non-constant operand stays, while the constant one becomes a literal.
+    auto& block =
+        *root.lookupName<InstanceSymbol>("m").body.membersOfType<ProceduralBlockSymbol>().begin();
+    auto& assign = block.getBody().as<ExpressionStatement>().expr.as<AssignmentExpression>();
+    const Expression* rhs = &assign.right();
+    while (rhs->kind == ExpressionKind::Conversion)
+        rhs = &rhs->as<ConversionExpression>().operand();
+
+    auto& add = rhs->as<BinaryExpression>();
+    CHECK(add.left().kind != ExpressionKind::IntegerLiteral);
+    CHECK(add.right().kind == ExpressionKind::IntegerLiteral);
+}
+
+TEST_CASE("Bind-time constant folding keeps diagnostics") {
+    auto tree = SyntaxTree::fromText(R"(
+module m;
+    localparam int P = 1;
+    typedef enum logic [3:0] { A = 1 << (P + 1), B = P + 4, C = 8'd1 << P } e_t;
+endmodule
+)");
+
+    auto getCodes = [&](bool fold) {
+        CompilationOptions co;
+        co.foldConstants = fold;
+
+        Bag options;
+        options.set(co);
+
+        Compilation compilation(options);
+        compilation.addSyntaxTree(tree);
+
+        std::vector<DiagCode> codes;
+        for (auto& diag : compilation.getAllDiagnostics())
+            codes.push_back(diag.code);
+        return codes;
+    };
+
+    // Only the sized literal is reported, folded or not.
+    auto codes = getCodes(true);
+    CHECK(codes == getCodes(false));
+    REQUIRE(codes.size() == 1);
+    CHECK(codes[0] == diag::EnumValueSizeMismatch);
+}
@@ -1,5 +1,7 @@
 #include "Test.h"
 
+#include <fstream>
+
 std::string getTestInclude() {
     return findTestDir() + "/include.svh";
 }
@@ -68,3 +70,176 @@ TEST_CASE("Read header (include dirs)") {
     buffer = manager.readHeader("../infinite_chain.svh", SourceLocation(buffer.id, 0), false);
     CHECK(buffer);
 }
+
+TEST_CASE("Loaded files list") {
+    SourceManager manager;
+    manager.addUserDirectory(string_view(manager.makeAbsolutePath(string_view(findTestDir()))));
+
+    manager.assignText("in_memory.sv", "module m; endmodule");
+    CHECK(manager.readHeader("local.svh", SourceLocation(), false));
+    CHECK(manager.readHeader("include.svh", SourceLocation(), false));
+    CHECK(manager.readHeader("include.svh", SourceLocation(), false));
+    CHECK(!manager.readHeader("nonexistent.svh", SourceLocation(), false));
+
+    auto files = manager.getLoadedFiles();
+    REQUIRE(files.size() == 2);
+    CHECK(string_view(files[0]).substr(files[0].size() - 11) == "include.svh");
+    CHECK(string_view(files[1]).substr(files[1].size() - 9) == "local.svh");
+}
+
+TEST_CASE("Buffer eviction") {
+    SourceManager manager;
+    manager.setBufferEviction(true);
+    manager.addUserDirectory(string_view(manager.makeAbsolutePath(string_view(findTestDir()))));
+
+    auto& text = R"(
+`include "file_defn.svh"
+`define BAZ(x) x + `FOO
+module m;
+    string s = `BAZ("a");
+endmodule
+)";
+
+    auto tree1 = SyntaxTree::fromText(text, manager);
+    auto tree2 = SyntaxTree::fromText(text, manager);
+    auto buffer1 = tree1->getEOFToken().location().buffer();
+    auto buffer2 = tree2->getEOFToken().location().buffer();
+    CHECK(!manager.getSourceText(buffer1).empty());
+    CHECK(manager.getLoadedFiles().size() == 1);
+
+    // The header stays loaded while any tree still uses it.
+    tree1.reset();
+    CHECK(manager.getSourceText(buffer1).empty());
+    CHECK(!manager.getSourceText(buffer2).empty());
+    CHECK(manager.getLoadedFiles().size() == 1);
+
+    auto before = manager.assignText("before");
+    tree2.reset();
+    CHECK(manager.getSourceText(buffer2).empty());
+    CHECK(manager.getLoadedFiles().empty());
+
+    // Freed buffer IDs get reused; the second tree's worth of
+    // entries is still free after parsing the third.
+    auto tree3 = SyntaxTree::fromText(text, manager);
+    auto after = manager.assignText("after");
+    CHECK(after.id.getId() < before.id.getId());
+    CHECK(manager.getLoadedFiles().size() == 1);
+    CHECK(tree3->diagnostics().empty());
+}
+
+TEST_CASE("External text buffers") {
+    SourceManager manager;
+    manager.setBufferEviction(true);
+
+    auto text = std::make_shared<std::string>("module m; endmodule");
+    CHECK_THROWS_AS(manager.assignExternalText("ext.sv", *text, text), std::invalid_argument);
+
+    // Include the null terminator in the view.
+    string_view view(text->c_str(), text->size() + 1);
+    auto buffer = manager.assignExternalText("ext.sv", view, text);
+    CHECK(buffer.data.data() == text->c_str());
+    CHECK(manager.getSourceText(buffer.id).data() == text->c_str());
+
+    std::weak_ptr<std::string> weak = text;
+    text.reset();
+    CHECK(!weak.expired());
+
+    auto tree = SyntaxTree::fromBuffer(buffer, manager);
+    CHECK(tree->diagnostics().empty());
+    CHECK(manager.getLineNumber(tree->getEOFToken().location()) == 1);
+
+    // The memory is let go once the only tree using it is gone.
+    tree.reset();
+    CHECK(weak.expired());
+}
+
+TEST_CASE("Include prefetching") {
+    SourceManager manager;
+    manager.addUserDirectory(string_view(manager.makeAbsolutePath(string_view(findTestDir()))));
+
+    auto buffer = manager.assignText("top.sv", R"(
+`include "include.svh" // `include <system.svh>
+`include  "infinite_chain.svh"
+`include `FOO
+`include_foo "local.svh"
+)");
+    manager.prefetchIncludes(buffer);
+    manager.waitForPrefetch();
+
+    // Prefetched files don't count as loaded until something reads them.
+    CHECK(manager.getLoadedFiles().empty());
+    CHECK(manager.readHeader("include.svh", SourceLocation(buffer.id, 0), false));
+    CHECK(manager.getLoadedFiles().size() == 1);
+
+    SourceManager manager2;
+    manager2.addUserDirectory(string_view(manager2.makeAbsolutePath(string_view(findTestDir()))));
+
+    PreprocessorOptions ppOptions;
+    ppOptions.prefetchIncludes = true;
+    Bag options;
+    options.set(ppOptions);
+
+    auto tree = SyntaxTree::fromText(R"(
+`include "file_defn.svh"
+// `include "include.svh"
+module m;
+    string s = `FOO;
+endmodule
+)",
+                                     manager2, "source", options);
+    CHECK(tree->diagnostics().empty());
+
+    manager2.waitForPrefetch();
+    CHECK(manager2.getLoadedFiles().size() == 1);
+}
+
+TEST_CASE("Include prefetching -- cached contents") {
+    // Prefetch from a scratch directory and then change the files on disk; reading
+    // them afterwards gives the old contents only if they were loaded ahead of time.
+    auto dir = fs::temp_directory_path() / "slang_prefetch_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "sub");
+
+    auto writeFile = [&](const fs::path& path, const char* text) {
+        std::ofstream(path) << text;
+    };
+    writeFile(dir / "a.svh", "`include \"sub/b.svh\"\n");
+    writeFile(dir / "sub" / "b.svh", "`include \"c.svh\"\n");
+    writeFile(dir / "sub" / "c.svh", "old");
+    writeFile(dir / "unused.svh", "old");
+
+    SourceManager manager;
+    manager.setBufferEviction(true);
+    manager.addUserDirectory(dir.string());
+
+    PreprocessorOptions ppOptions;
+    ppOptions.prefetchIncludes = true;
+    Bag options;
+    options.set(ppOptions);
+
+    auto tree = SyntaxTree::fromText("// `include \"a.svh\"\n// `include \"unused.svh\"\n",
+                                     manager, "source", options);
+    manager.waitForPrefetch();
+    writeFile(dir / "sub" / "c.svh", "new");
+    writeFile(dir / "unused.svh", "new");
+
+    // Nested includes were fetched relative to the files that include them.
+    auto root = tree->getEOFToken().location();
+    auto a = manager.readHeader("a.svh", root, false);
+    REQUIRE(a);
+    auto b = manager.readHeader("sub/b.svh", SourceLocation(a.id, 0), false);
+    REQUIRE(b);
+    auto c = manager.readHeader("c.svh", SourceLocation(b.id, 0), false);
+    REQUIRE(c);
+    CHECK(c.data.substr(0, 3) == "old");
+    CHECK(manager.getLoadedFiles().size() == 3);
+
+    // Whatever was fetched on behalf of the tree goes away with it.
+    tree.reset();
+    CHECK(manager.getLoadedFiles().empty());
+    auto unused = manager.readHeader("unused.svh", SourceLocation(), false);
+    REQUIRE(unused);
+    CHECK(unused.data.substr(0, 3) == "new");
+
+    fs::remove_all(dir);
+}
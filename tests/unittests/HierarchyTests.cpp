@@ -1,5 +1,7 @@
 #include "Test.h"
 
+#include "slang/symbols/DesignFingerprint.h"
+
 TEST_CASE("Finding top level") {
     auto file1 = SyntaxTree::fromText(
         "module A; endmodule\nmodule B; A a(); endmodule\nmodule C; endmodule");
@@ -157,12 +159,12 @@ endmodule
     CHECK(diags[8].code == diag::LocalParamNoInitializer);
     CHECK(diags[9].code == diag::BodyParamNoInitializer);
 
-    REQUIRE(diags[3].notes.size() == 1);
-    REQUIRE(diags[5].notes.size() == 1);
-    REQUIRE(diags[6].notes.size() == 1);
-    CHECK(diags[3].notes[0].code == diag::NoteDeclarationHere);
-    CHECK(diags[5].notes[0].code == diag::NoteDeclarationHere);
-    CHECK(diags[6].notes[0].code == diag::NotePreviousUsage);
+    REQUIRE(diags[3].notes().size() == 1);
+    REQUIRE(diags[5].notes().size() == 1);
+    REQUIRE(diags[6].notes().size() == 1);
+    CHECK(diags[3].notes()[0].code == diag::NoteDeclarationHere);
+    CHECK(diags[5].notes()[0].code == diag::NoteDeclarationHere);
+    CHECK(diags[6].notes()[0].code == diag::NotePreviousUsage);
 }
 
 TEST_CASE("Module children (simple)") {
@@ -868,6 +870,67 @@ endmodule
     CHECK(diags[0].code == diag::MaxGenerateStepsExceeded);
 }
 
+TEST_CASE("Compilation memory budget") {
+    auto tree = SyntaxTree::fromText(R"(
+module leaf;
+    logic [7:0] a, b, c, d;
+    assign a = b + c + d;
+endmodule
+
+module top;
+    for (genvar i = 0; i < 4096; i++) begin : g
+        leaf l();
+    end
+endmodule
+)");
+
+    CompilationOptions co;
+    co.memoryLimit = 1024 * 1024;
+
+    Bag options;
+    options.set(co);
+
+    Compilation compilation(options);
+    compilation.addSyntaxTree(tree);
+
+    auto& diags = compilation.getAllDiagnostics();
+    REQUIRE(diags.size() == 1);
+    CHECK(diags[0].code == diag::CompilationBudgetExceeded);
+    CHECK(compilation.isOverBudget());
+    CHECK(compilation.getBytesAllocated() > co.memoryLimit);
+}
+
+TEST_CASE("Compilation cancellation") {
+    auto& text = R"(
+module leaf;
+    assign a = b;
+endmodule
+
+module top;
+    leaf l();
+endmodule
+)";
+
+    auto token = CancellationToken::create();
+    CompilationOptions co;
+    co.cancellation = token;
+
+    Bag options;
+    options.set(co);
+
+    Compilation compilation(options);
+    compilation.addSyntaxTree(SyntaxTree::fromText(text));
+    CHECK(!compilation.getAllDiagnostics().empty());
+    CHECK(!compilation.isCancelled());
+
+    token.cancel();
+    Compilation cancelled(options);
+    cancelled.addSyntaxTree(SyntaxTree::fromText(text));
+    CHECK(cancelled.getAllDiagnostics().empty());
+    CHECK(cancelled.isCancelled());
+    CHECK(cancelled.isOverBudget());
+}
+
 TEST_CASE("Single-unit multi-file") {
     SourceManager& sourceManager = SyntaxTree::getDefaultSourceManager();
     std::array<SourceBuffer, 2> buffers;
@@ -1176,3 +1239,252 @@ endmodule
     compilation.addSyntaxTree(tree);
     NO_COMPILATION_ERRORS;
 }
+
+TEST_CASE("Design fingerprint") {
+    auto fingerprint = [](string_view text) {
+        Compilation compilation;
+        compilation.addSyntaxTree(SyntaxTree::fromText(text));
+        NO_COMPILATION_ERRORS;
+        return DesignFingerprint(compilation);
+    };
+
+    auto base = fingerprint(R"(
+module leaf #(parameter int W = 1)(input logic [W-1:0] a);
+    logic [W-1:0] b;
+    assign b = a;
+endmodule
+
+module top;
+    logic [3:0] x;
+    leaf #(4) l1(.a(x));
+    leaf l2(.a(x[0]));
+endmodule
+)");
+
+    // Comments, whitespace, and reordering of definitions don't matter.
+    auto same = fingerprint(R"(
+module top;
+    logic [3:0] x; // comment
+    leaf #(4)   l1(.a(x));
+
+    leaf l2(.a(x[0]));
+endmodule
+
+module leaf #(parameter int W = 1)(input logic [W-1:0] a);
+    /* more comments */ logic [W-1:0] b;
+    assign b = a;
+endmodule
+)");
+
+    // Only the second child changes here.
+    auto changed = fingerprint(R"(
+module leaf #(parameter int W = 1)(input logic [W-1:0] a);
+    logic [W-1:0] b;
+    assign b = a;
+endmodule
+
+module top;
+    logic [3:0] x;
+    leaf #(4) l1(.a(x));
+    leaf l2(.a(x[1]));
+endmodule
+)");
+
+    REQUIRE(base.getTopNodes().size() == 1);
+    REQUIRE(base.getTopNodes()[0].children.size() == 2);
+    CHECK(base.getDesignHash() == same.getDesignHash());
+
+    auto& b = base.getTopNodes()[0];
+    auto& c = changed.getTopNodes()[0];
+    CHECK(base.getDesignHash() != changed.getDesignHash());
+    CHECK(b.bodyHash != c.bodyHash);
+    CHECK(b.children[0].subtreeHash == c.children[0].subtreeHash);
+    CHECK(b.children[0].subtreeHash != b.children[1].subtreeHash);
+    CHECK(b.children[1].subtreeHash == c.children[1].subtreeHash);
+}
+
+TEST_CASE("Name lookups avoid elaborating deferred members") {
+    auto tree = SyntaxTree::fromText(R"(
+module leaf; endmodule
+
+module top;
+    typedef logic [3:0] nibble_t;
+    localparam int P = 4;
+    leaf l1();
+    if (P == 4) begin : g
+        leaf l2();
+    end
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+
+    auto& top = compilation.getRoot().lookupName<InstanceSymbol>("top");
+    auto& stats = compilation.getElaborationStats();
+    auto before = stats.scopesElaborated;
+
+    // Names declared directly in the body resolve without expanding
+    // the instance and generate block.
+    CHECK(top.body.find("nibble_t"));
+    CHECK(top.body.lookupName("P"));
+    CHECK(stats.scopesElaborated == before);
+    CHECK(stats.lookupsWithoutElaboration >= 2);
+
+    // A name that only a deferred member provides forces elaboration.
+    CHECK(top.body.find("g"));
+    CHECK(stats.scopesElaborated > before);
+
+    NO_COMPILATION_ERRORS;
+}
+
+TEST_CASE("Compilation compaction") {
+    auto tree = SyntaxTree::fromText(R"(
+module leaf(input logic a);
+    logic b = a;
+endmodule
+
+module checker_mod(input logic a); endmodule
+
+module top;
+    logic x, y;
+    leaf l1(.a(x)), l2(.a(x));
+    assign y = z;
+    bind top.l2 checker_mod c(.a(a));
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+
+    auto& top = compilation.getRoot().lookupName<InstanceSymbol>("top");
+    CHECK(top.body.membersOfKind(SymbolKind::Instance).size() == 2);
+
+    auto stats = compilation.compact();
+    CHECK(stats.bytesReclaimed > 0);
+    CHECK(stats.entriesReleased > 0);
+
+    // Everything is still usable afterward.
+    auto& diags = compilation.getAllDiagnostics();
+    REQUIRE(diags.size() == 1);
+    CHECK(diags[0].code == diag::UndeclaredIdentifier);
+    CHECK(compilation.getRoot().lookupName("top.l2.c"));
+    CHECK(top.body.membersOfKind(SymbolKind::Instance).size() == 2);
+}
+
+TEST_CASE("Compilation compaction -- unreferenced trees") {
+    CompilationOptions coptions;
+    coptions.topModules.emplace("top"sv);
+
+    Bag options;
+    options.set(coptions);
+
+    Compilation compilation(options);
+    compilation.addSyntaxTree(SyntaxTree::fromText(R"(
+module leaf; endmodule
+module top;
+    leaf l1();
+    unused_if i();
+endmodule
+)"));
+    compilation.addSyntaxTree(SyntaxTree::fromText(R"(
+module unused1; logic a; endmodule
+interface unused_if; endinterface
+)"));
+    compilation.addSyntaxTree(SyntaxTree::fromText(R"(
+module unused2; logic a; endmodule
+program unused3; endprogram
+)"));
+    compilation.addSyntaxTree(SyntaxTree::fromText("module unused4; endmodule"));
+    compilation.addSyntaxTree(SyntaxTree::fromText(R"(
+module unused5; assign b = undeclared; endmodule
+module unused6; endmodule
+)"));
+
+    auto kept = SyntaxTree::fromText(R"(
+module unused7; endmodule
+module unused8; endmodule
+)");
+    compilation.addSyntaxTree(kept);
+
+    auto countInstances = [&] {
+        size_t count = 0;
+        for (auto& member : compilation.getRoot().members()) {
+            if (member.kind == SymbolKind::Instance)
+                count++;
+        }
+        return count;
+    };
+
+    CHECK(countInstances() == 9);
+    CHECK(compilation.getSyntaxTrees().size() == 6);
+
+    // The second tree has an instantiated interface, the fifth has a diagnostic,
+    // and the last is still held by us, so only the third and fourth can be released.
+    auto stats = compilation.compact();
+    CHECK(stats.treesReleased == 2);
+    CHECK(stats.bytesReclaimed > 0);
+    CHECK(compilation.getSyntaxTrees().size() == 4);
+    CHECK(compilation.getCompilationUnits().size() == 4);
+    CHECK(compilation.getRoot().compilationUnits.size() == 4);
+    CHECK(!compilation.getDefinition("unused2"));
+    CHECK(!compilation.getDefinition("unused3"));
+    CHECK(!compilation.getDefinition("unused4"));
+    CHECK(compilation.getDefinition("unused1"));
+    CHECK(compilation.getDefinition("unused5"));
+    CHECK(compilation.getDefinition("unused7"));
+    CHECK(countInstances() == 6);
+
+    auto& diags = compilation.getAllDiagnostics();
+    REQUIRE(diags.size() == 1);
+    CHECK(diags[0].code == diag::UndeclaredIdentifier);
+}
+
+TEST_CASE("Hierarchy-only elaboration") {
+    auto tree = SyntaxTree::fromText(R"(
+module leaf #(parameter int W = 1) (input logic [W-1:0] a, output logic b);
+    always_comb b = undeclared1;
+    assign b = undeclared2;
+    function int f; return undeclared3; endfunction
+    logic c = undeclared4;
+endmodule
+
+module top;
+    localparam int P = missing;
+    logic [3:0] x;
+    leaf #(.W(4)) l1(.a(x), .b(), .c(x));
+endmodule
+)");
+
+    auto getDiags = [&](bool hierarchyOnly) {
+        CompilationOptions co;
+        co.hierarchyOnly = hierarchyOnly;
+
+        Bag options;
+        options.set(co);
+
+        auto compilation = std::make_unique<Compilation>(options);
+        compilation->addSyntaxTree(tree);
+
+        std::vector<DiagCode> codes;
+        for (auto& diag : compilation->getAllDiagnostics())
+            codes.push_back(diag.code);
+        return std::make_pair(std::move(compilation), codes);
+    };
+
+    auto [full, fullCodes] = getDiags(false);
+    CHECK(fullCodes.size() == 6);
+
+    auto [compilation, codes] = getDiags(true);
+    REQUIRE(codes.size() == 2);
+    CHECK(codes[0] == diag::UndeclaredIdentifier);
+    CHECK(codes[1] == diag::PortDoesNotExist);
+
+    auto& l1 = compilation->getRoot().lookupName("top.l1")->as<InstanceSymbol>();
+    auto& port = l1.body.findPort("a")->as<PortSymbol>();
+    CHECK(port.getType().getBitWidth() == 4);
+
+    // Procedural code can still be bound on request.
+    auto& block = *l1.body.membersOfType<ProceduralBlockSymbol>().begin();
+    CHECK(block.getBody().bad());
+}
@@ -108,10 +108,10 @@ endmodule
     auto& diags = compilation.getAllDiagnostics();
     REQUIRE(diags.size() == 1);
     CHECK(diags[0].code == diag::ImportNameCollision);
-    REQUIRE(diags[0].notes.size() == 3);
-    CHECK(diags[0].notes[0].code == diag::NoteDeclarationHere);
-    CHECK(diags[0].notes[1].code == diag::NoteImportedFrom);
-    CHECK(diags[0].notes[2].code == diag::NoteDeclarationHere);
+    REQUIRE(diags[0].notes().size() == 3);
+    CHECK(diags[0].notes()[0].code == diag::NoteDeclarationHere);
+    CHECK(diags[0].notes()[1].code == diag::NoteImportedFrom);
+    CHECK(diags[0].notes()[2].code == diag::NoteDeclarationHere);
 }
 
 TEST_CASE("Wildcard import lookup 3") {
@@ -1,5 +1,6 @@
 #include "Test.h"
 
+#include "slang/mir/Interpreter.h"
 #include "slang/mir/MIRBuilder.h"
 #include "slang/mir/MIRPrinter.h"
 #include "slang/mir/Procedure.h"
@@ -45,4 +46,130 @@ L0 i: int
 %5 = syscall $printStr  world: string
 %6 = syscall $flush 1'b1: bit[0:0]
 )");
-}
\ No newline at end of file
+}
+
+TEST_CASE("MIR -- interpreter") {
+    auto tree = SyntaxTree::fromText(R"(
+module m;
+    int j = 4;
+    logic [3:0] k = 4'b1010;
+    int l = j + 1;
+    initial begin : block
+        automatic int i = 3;
+        $display(-i, , "hello %0d world", j);
+        $display(~k, , &k, , ^k);
+        $display("l = %0d", l);
+    end
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+
+    MIRBuilder builder(compilation);
+    builder.elaborate();
+    REQUIRE(builder.getInitialProcs().size() == 1);
+
+    std::string output;
+    Interpreter interpreter(builder);
+    interpreter.setOutputHandler([&](std::string_view text) { output += text; });
+
+    auto& proc = *builder.getInitialProcs()[0];
+    interpreter.run(proc);
+    interpreter.run(proc);
+
+    CHECK(interpreter.getExecutionCount(proc) == 2);
+    CHECK(output == "         -3 hello 4 world\n 5 0 0\nl = 5\n"
+                    "         -3 hello 4 world\n 5 0 0\nl = 5\n");
+}
+
+TEST_CASE("MIR -- interpreter checkpoints") {
+    auto makeTree = [](const std::string& globals) {
+        return SyntaxTree::fromText("module m; " + globals +
+                                    " initial $display(j, , k, , w); endmodule");
+    };
+
+    Compilation compA;
+    compA.addSyntaxTree(makeTree("int j = 4; logic [3:0] k = 4'b1x0z; bit [99:0] w = 1 << 80;"));
+    CHECK(compA.getAllDiagnostics().empty());
+
+    MIRBuilder builderA(compA);
+    builderA.elaborate();
+
+    std::string output;
+    auto handler = [&](std::string_view text) { output += text; };
+
+    Interpreter interpA(builderA);
+    interpA.setOutputHandler(handler);
+    interpA.run(*builderA.getInitialProcs()[0]);
+
+    std::string checkpoint;
+    REQUIRE(interpA.saveCheckpoint(checkpoint));
+
+    // Same globals with different initial values; restoring should bring
+    // back the values and execution counts from the first design.
+    Compilation compB;
+    compB.addSyntaxTree(makeTree("int j = 7; logic [3:0] k; bit [99:0] w;"));
+    CHECK(compB.getAllDiagnostics().empty());
+
+    MIRBuilder builderB(compB);
+    builderB.elaborate();
+
+    Interpreter interpB(builderB);
+    interpB.setOutputHandler(handler);
+    REQUIRE(interpB.restoreCheckpoint(checkpoint));
+
+    auto& procB = *builderB.getInitialProcs()[0];
+    CHECK(interpB.getExecutionCount(procB) == 1);
+    for (size_t i = 0; i < 3; i++) {
+        auto global = MIRValue::global(i);
+        CHECK(interpB.getGlobal(global) == interpA.getGlobal(global));
+    }
+
+    interpB.run(procB);
+    CHECK(interpB.getExecutionCount(procB) == 2);
+
+    auto pos = output.find('\n');
+    REQUIRE(pos != std::string::npos);
+    CHECK(output.substr(0, pos + 1) == output.substr(pos + 1));
+
+    // Truncated data and data from a different design are rejected.
+    CHECK(!interpB.restoreCheckpoint(string_view(checkpoint).substr(0, checkpoint.size() - 1)));
+
+    Compilation compC;
+    compC.addSyntaxTree(makeTree("int j = 4; logic [4:0] k; bit [99:0] w;"));
+    CHECK(compC.getAllDiagnostics().empty());
+
+    MIRBuilder builderC(compC);
+    builderC.elaborate();
+    CHECK(!Interpreter(builderC).restoreCheckpoint(checkpoint));
+
+    // Values have to fit the types of their globals. The header is the magic,
+    // version, and design hash; j follows as tag, width, sign, and four bytes.
+    const size_t headerSize = 13;
+    const size_t jSize = 7;
+    std::string header = checkpoint.substr(0, headerSize);
+    std::string rest = checkpoint.substr(headerSize + jSize);
+
+    double d = 1.0;
+    std::string realJ = header + '\x03';
+    realJ.append(reinterpret_cast<const char*>(&d), sizeof(d));
+    realJ += rest;
+    CHECK(!interpB.restoreCheckpoint(realJ));
+
+    std::string narrowJ = header + std::string("\x01\x10\x01\x04\x00", 5) + rest;
+    CHECK(!interpB.restoreCheckpoint(narrowJ));
+
+    // Deeply nested values are rejected without recursing all the way down.
+    std::string nested = header;
+    for (int i = 0; i < 100000; i++)
+        nested += "\x06\x01";
+    CHECK(!interpB.restoreCheckpoint(nested));
+
+    // None of the failed restores touched the state.
+    for (size_t i = 0; i < 3; i++) {
+        auto global = MIRValue::global(i);
+        CHECK(interpB.getGlobal(global) == interpA.getGlobal(global));
+    }
+}
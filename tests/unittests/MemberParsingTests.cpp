@@ -520,3 +520,81 @@ endmodule
     CHECK(diagnostics[3].code == diag::DriveStrengthInvalid);
     CHECK(diagnostics[4].code == diag::DriveStrengthHighZ);
 }
+
+TEST_CASE("Parser cancellation") {
+    auto token = CancellationToken::create();
+    ParserOptions parserOptions;
+    parserOptions.cancellation = token;
+
+    Bag options;
+    options.set(parserOptions);
+
+    auto& text = R"(
+module m; endmodule
+module n; endmodule
+)";
+
+    auto& sm = SyntaxTree::getDefaultSourceManager();
+    auto tree = SyntaxTree::fromBuffer(sm.assignText(text), sm, options);
+    CHECK(tree->root().as<CompilationUnitSyntax>().members.size() == 2);
+
+    token.cancel();
+    tree = SyntaxTree::fromBuffer(sm.assignText(text), sm, options);
+    CHECK(tree->root().as<CompilationUnitSyntax>().members.empty());
+
+    // Snippets are parsed by guessing what they are, which can reach a member
+    // list without going through a compilation unit.
+    tree = SyntaxTree::fromText("obj.randomize() with { x > 0; };", sm, "", options);
+    CHECK(tree->root().as<CompilationUnitSyntax>().members.empty());
+}
+
+TEST_CASE("Parallel single-unit parsing") {
+    auto& sm = SyntaxTree::getDefaultSourceManager();
+    auto check = [&](std::vector<std::string> texts) {
+        std::vector<SourceBuffer> buffers;
+        for (auto& text : texts)
+            buffers.push_back(sm.assignText(text));
+
+        auto serial = SyntaxTree::fromBuffers(buffers, sm);
+        auto parallel = SyntaxTree::fromBuffersParallel(buffers, sm, {}, 4);
+
+        CHECK(parallel->root().toString() == serial->root().toString());
+        CHECK(parallel->getEOFToken().trivia().size() == serial->getEOFToken().trivia().size());
+        CHECK(parallel->getMetadata().nodeMap.size() == serial->getMetadata().nodeMap.size());
+
+        auto& pd = parallel->diagnostics();
+        auto& sd = serial->diagnostics();
+        REQUIRE(pd.size() == sd.size());
+        for (size_t i = 0; i < pd.size(); i++) {
+            CHECK(pd[i].code == sd[i].code);
+            CHECK(pd[i].location == sd[i].location);
+        }
+    };
+
+    // Macros, directives, and trailing trivia carried across files,
+    // including files that contain no tokens at all.
+    check({ R"(
+`define WIDTH 8
+`timescale 1ns/1ps
+// trailing comment
+)",
+            "", R"(
+`default_nettype none
+module a(input logic [`WIDTH-1:0] x); endmodule
+`define OTHER(p) p + 1 // comment
+)",
+            R"(
+module b; localparam int q = `OTHER(`WIDTH); a a1(.x('0)); endmodule
+/* block comment */)",
+            R"(`ifdef WIDTH
+module c; endmodule
+`endif
+`undef WIDTH
+`define WIDTH 3 // redefined)" });
+
+    // A module that spans two files has to fall back to the serial path.
+    check({ "module d;\n", "  logic x;\nendmodule\n", "module e; endmodule\n" });
+
+    // So does a conditional block that spans files.
+    check({ "`ifdef FOO\n", "module f; endmodule\n`endif\n" });
+}
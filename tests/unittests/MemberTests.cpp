@@ -899,6 +899,114 @@ endmodule
     NO_COMPILATION_ERRORS;
 }
 
+TEST_CASE("Compact gate storage") {
+    auto tree = SyntaxTree::fromText(R"(
+module m;
+    wire a, b, c;
+    wire [3:0] bus;
+    and g1(c, a, b);
+    or (c, a, bus[2]), g2(bus, a, b & c);
+    not g3[1:0] (a, b);
+    (* keep *) buf g4(a, b);
+endmodule
+)");
+
+    CompilationOptions co;
+    co.compactGates = true;
+
+    Bag options;
+    options.set(co);
+
+    Compilation compilation(options);
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+
+    auto& m = compilation.getRoot().topInstances[0]->body;
+    CHECK(m.membersOfType<GateSymbol>().size() == 1);
+    CHECK(m.membersOfType<GateArraySymbol>().size() == 1);
+
+    auto table = m.getGateTable();
+    REQUIRE(table);
+    REQUIRE(table->size() == 3);
+    CHECK(table->getName(0) == "g1");
+    CHECK(table->getName(1) == "");
+    CHECK(table->getGateType(2) == GateType::Or);
+
+    auto netName = [&](const GateTable::Connection& conn) {
+        return conn.net == GateTable::Connection::NoNet ? ""sv : table->getNetName(conn.net);
+    };
+
+    auto conns = table->getConnections(1);
+    REQUIRE(conns.size() == 3);
+    CHECK(netName(conns[0]) == "c");
+    CHECK(conns[0].bit == GateTable::Connection::WholeNet);
+    CHECK(netName(conns[2]) == "bus");
+    CHECK(conns[2].bit == 2);
+
+    conns = table->getConnections(2);
+    REQUIRE(conns.size() == 3);
+    CHECK(netName(conns[0]) == "bus");
+    CHECK(conns[2].net == GateTable::Connection::NoNet);
+    CHECK(table->numNets() == 4);
+
+    auto g2 = m.find("g2");
+    REQUIRE(g2);
+    CHECK(g2->kind == SymbolKind::Gate);
+    CHECK(g2->as<GateSymbol>().gateType == GateType::Or);
+    CHECK(g2->getParentScope() == &m);
+    CHECK(g2 == &table->getSymbol(2));
+
+    auto lookup = compilation.getRoot().lookupName("m.g1");
+    REQUIRE(lookup);
+    CHECK(lookup->kind == SymbolKind::Gate);
+}
+
+TEST_CASE("Compact gate storage -- JSON and name conflicts") {
+    auto tree = SyntaxTree::fromText(R"(
+module leaf; endmodule
+module m;
+    wire a, b, c;
+    and g1(c, a, b), (a, b, c);
+    nor g2(c, a, b);
+endmodule
+module n;
+    wire a, b, c;
+    and x(c, a, b);
+    leaf x();
+    or y(a, b, c);
+    or y(a, b, c);
+endmodule
+)");
+
+    auto getJson = [&](bool compactGates) {
+        CompilationOptions co;
+        co.compactGates = compactGates;
+        co.topModules.emplace("m");
+        co.topModules.emplace("n");
+
+        Bag options;
+        options.set(co);
+
+        Compilation compilation(options);
+        compilation.addSyntaxTree(tree);
+
+        auto& diags = compilation.getAllDiagnostics();
+        REQUIRE(diags.size() == 2);
+        CHECK(diags[0].code == diag::RedefinitionDifferentSymbolKind);
+        CHECK(diags[1].code == diag::Redefinition);
+
+        JsonWriter writer;
+        ASTSerializer serializer(compilation, writer);
+        serializer.setIncludeAddresses(false);
+        serializer.serialize(*compilation.getRoot().find("m"));
+        return std::string(writer.view());
+    };
+
+    auto json = getJson(true);
+    CHECK(json == getJson(false));
+    CHECK(json.find("\"g2\"") != std::string::npos);
+}
+
 TEST_CASE("Implicit nets") {
     auto tree = SyntaxTree::fromText(R"(
 module n(input logic a, output b);
@@ -1241,3 +1349,43 @@ endmodule
     CHECK(diags[2].code == diag::InvalidRefArg);
     CHECK(diags[3].code == diag::RefTypeMismatch);
 }
+
+TEST_CASE("Scope members by kind") {
+    auto tree = SyntaxTree::fromText(R"(
+module m;
+    logic a;
+    wire b;
+    always_comb a = b;
+    logic c;
+    initial begin end
+    wire d;
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+
+    auto& body = compilation.getRoot().lookupName<InstanceSymbol>("m").body;
+    auto vars = body.membersOfKind(SymbolKind::Variable);
+    REQUIRE(vars.size() == 2);
+    CHECK(vars[0]->name == "a");
+    CHECK(vars[1]->name == "c");
+    CHECK(body.membersOfKind(SymbolKind::Net).size() == 2);
+    CHECK(body.membersOfKind(SymbolKind::ProceduralBlock).size() == 2);
+    CHECK(body.membersOfKind(SymbolKind::Parameter).empty());
+
+    auto array = body.getMemberArray();
+    CHECK(array.size() == size_t(std::distance(body.members().begin(), body.members().end())));
+    CHECK(body.memberAt<VariableSymbol>(3).name == "c");
+
+    // Adding a member drops the stale index.
+    auto& scope = compilation.createScriptScope();
+    scope.addMember(*compilation.emplace<VariableSymbol>("x", SourceLocation(),
+                                                          VariableLifetime::Static));
+    CHECK(scope.membersOfKind(SymbolKind::Variable).size() == 1);
+    scope.addMember(*compilation.emplace<VariableSymbol>("y", SourceLocation(),
+                                                          VariableLifetime::Static));
+    CHECK(scope.membersOfKind(SymbolKind::Variable).size() == 2);
+    CHECK(scope.getMemberArray().size() == 2);
+}
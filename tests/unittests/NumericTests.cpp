@@ -1,5 +1,7 @@
 #include "Test.h"
 
+#include "slang/numeric/ConstantValue.h"
+#include "slang/numeric/MemoryFile.h"
 #include "slang/numeric/SVInt.h"
 
 TEST_CASE("Construction") {
@@ -755,4 +757,87 @@ TEST_CASE("Time scaling") {
     CHECK(scale.apply(234.0567891, TimeUnit::Nanoseconds) == AP(234));
     CHECK(scale.apply(234.0567891, TimeUnit::Picoseconds) == AP(0));
     CHECK(scale.apply(234.0567891, TimeUnit::Seconds) == AP(234056789100));
-}
\ No newline at end of file
+}
+
+TEST_CASE("MemoryFile parsing") {
+    std::vector<std::pair<uint64_t, SVInt>> words;
+    auto collect = [&](uint64_t addr, SVInt&& value) { words.emplace_back(addr, std::move(value)); };
+
+    MemoryFile::Options options;
+    options.wordWidth = 100;
+    options.highAddress = 15;
+
+    auto result = MemoryFile::parse("123456789abcdef0123456789 // comment\n"
+                                    "@f 1_2 z",
+                                    options, collect);
+    CHECK(result);
+    CHECK(result.wordsLoaded == 2);
+    REQUIRE(words.size() == 2);
+    CHECK(words[0].first == 0);
+    CHECK(words[0].second == "100'h123456789abcdef0123456789"_si);
+    CHECK(words[1].first == 15);
+    CHECK(words[1].second == "100'h12"_si);
+
+    words.clear();
+    options.wordWidth = 12;
+    options.isHex = false;
+    options.start = 3;
+    options.finish = 1;
+    result = MemoryFile::parse("111100001111 1 10 11", options, collect);
+    CHECK(result);
+    REQUIRE(words.size() == 3);
+    CHECK(words[0].first == 3);
+    CHECK(words[0].second == "12'hf0f"_si);
+    CHECK(words[2].first == 1);
+    CHECK(words[2].second == 2);
+
+    result = MemoryFile::parse("@9 1", options, collect);
+    CHECK(result.error == MemoryFile::Error::AddressOutOfRange);
+
+    result = MemoryFile::parse("\n\n012", options, collect);
+    CHECK(result.error == MemoryFile::Error::InvalidDigit);
+    CHECK(result.line == 3);
+
+    // A finish address outside the memory is rejected before any words are stored.
+    words.clear();
+    options.highAddress = 3;
+    options.start = 0;
+    options.finish = 10;
+    result = MemoryFile::parse("1 1 1 1 1 1 1 1 1 1 1", options, collect);
+    CHECK(result.error == MemoryFile::Error::AddressOutOfRange);
+    CHECK(words.empty());
+
+    options.start = 10;
+    options.finish = 0;
+    result = MemoryFile::parse("1", options, collect);
+    CHECK(result.error == MemoryFile::Error::AddressOutOfRange);
+    CHECK(words.empty());
+}
+
+TEST_CASE("SVString copies") {
+    ConstantValue original = std::string("abc");
+    string_view before = original.svString().view();
+
+    // Appending to a copy must leave the original's buffer alone.
+    ConstantValue copy = original;
+    copy.svString().append("def");
+    CHECK(original.str() == "abc");
+    CHECK(original.svString().view().data() == before.data());
+    CHECK(copy.str() == "abcdef");
+
+    SVString joined;
+    joined.append(original.svString());
+    joined.append(copy.svString());
+    CHECK(joined.view() == "abcabcdef");
+    CHECK(original.str() == "abc");
+
+    // Assigning from another string doesn't disturb the source either.
+    SVString assigned;
+    assigned = copy.svString();
+    assigned.mutableStr() += "!";
+    CHECK(copy.str() == "abcdef");
+    CHECK(assigned.view() == "abcdef!");
+
+    std::string released = std::move(original).svString().release();
+    CHECK(released == "abc");
+}
@@ -1598,3 +1598,51 @@ TEST_CASE("Macro concat -- whitespace bug") {
     std::string result = preprocess(text);
     CHECK(result == "\nx port_width\n");
 }
+
+TEST_CASE("Directive-only scanning") {
+    auto& text = R"(
+// `define IN_COMMENT 1
+module m; /* `define IN_BLOCK
+   comment */ string s = "`define IN_STRING \" / ";
+    logic \esc`aped/ ;
+    `define A(x) x + \
+        1
+    int i = `A(3) / 2;
+`ifdef A
+    `define B "b"
+`else
+    `define C 1
+`endif
+    `include "file_defn.svh"
+endmodule
+`define D(a, b=1) a``b
+// trailing comment
+   )";
+
+    auto run = [&](bool directivesOnly, size_t& tokenCount) {
+        diagnostics.clear();
+        Preprocessor preprocessor(getSourceManager(), alloc, diagnostics);
+        preprocessor.setDirectivesOnly(directivesOnly);
+        preprocessor.pushSource(getSourceManager().assignText(text));
+
+        tokenCount = 0;
+        Token token;
+        while ((token = preprocessor.next()).kind != TokenKind::EndOfFile)
+            tokenCount++;
+
+        std::string result = token.toString();
+        for (auto macro : preprocessor.getDefinedMacros())
+            result += "\n" + macro->toString();
+        return result;
+    };
+
+    size_t fullCount, scanCount;
+    std::string full = run(false, fullCount);
+    CHECK_DIAGNOSTICS_EMPTY;
+
+    std::string scanned = run(true, scanCount);
+    CHECK_DIAGNOSTICS_EMPTY;
+    CHECK(scanned == full);
+    CHECK(scanCount < fullCount);
+    CHECK(full.find("IN_") == std::string::npos);
+}
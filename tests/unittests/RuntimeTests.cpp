@@ -0,0 +1,525 @@
+#include "Test.h"
+
+#include <fstream>
+
+#include "slang/runtime/FileIO.h"
+#include "slang/runtime/WaveDump.h"
+
+using namespace slang::runtime;
+
+// Runtime entry points that are normally only called from generated code.
+extern "C" {
+void printStr(const char* str, size_t len);
+void flushToFile(uint32_t fd, bool newline);
+uint32_t fileOpen(const char* path, size_t pathLen, const char* mode, size_t modeLen);
+void fileClose(uint32_t fd);
+int32_t fileGetc(uint32_t fd);
+int32_t fileUngetc(int32_t c, uint32_t fd);
+int32_t fileGets(uint32_t fd, uint64_t* storage, uint32_t width, bool isFourState);
+int32_t fileScanf(uint32_t fd, const char* format, size_t formatLen, ScanArg* args,
+                  uint32_t numArgs, const char* scope, size_t scopeLen);
+int32_t stringScanf(const char* str, size_t strLen, const char* format, size_t formatLen,
+                    ScanArg* args, uint32_t numArgs, const char* scope, size_t scopeLen);
+int32_t fileRead(uint32_t fd, uint64_t* storage, uint32_t width, bool isFourState);
+int64_t fileReadMemory(uint32_t fd, uint64_t* storage, uint32_t elemWidth, bool isFourState,
+                       uint64_t count);
+int32_t fileEof(uint32_t fd);
+int32_t fileError(uint32_t fd, ScanString* message);
+int32_t fileSeek(uint32_t fd, int64_t offset, int32_t operation);
+int64_t fileTell(uint32_t fd);
+int32_t fileRewind(uint32_t fd);
+}
+
+static std::string readFile(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+static fs::path getTempPath(const char* name) {
+    return fs::temp_directory_path() / name;
+}
+
+TEST_CASE("Wave dump -- VCD output") {
+    auto path = getTempPath("slang_wave_test.vcd");
+    {
+        WaveDumper dumper(path.string(), WaveFormat::VCD);
+        REQUIRE(dumper.isOpen());
+
+        auto clk = dumper.addSignal("top", "clk", 1, false, WaveVarKind::Wire);
+        auto data = dumper.addSignal("top.sub", "data", 4, true, WaveVarKind::Reg);
+        auto unset = dumper.addSignal("top.sub", "unset", 32, true, WaveVarKind::Integer);
+        dumper.selectScope("top", 0);
+
+        uint64_t zero = 0;
+        uint64_t one = 1;
+        uint64_t value = 0b0101;
+
+        dumper.setTime(0);
+        dumper.valueChanged(clk, &zero);
+        dumper.valueChanged(data, &value);
+
+        dumper.setTime(5);
+        dumper.valueChanged(clk, &one);
+
+        // Value bits 0101 with unknown bits 0110 read as 0zx1.
+        value = 0b0110'0101;
+        dumper.setTime(10);
+        dumper.valueChanged(data, &value);
+        dumper.valueChanged(unset, &zero);
+        dumper.close();
+
+        CHECK(dumper.getStats().changes == 5);
+    }
+
+    CHECK(readFile(path) == R"($timescale 1ns $end
+$scope module top $end
+$var wire 1 ! clk $end
+$scope module sub $end
+$var reg 4 " data $end
+$var integer 32 # unset $end
+$upscope $end
+$upscope $end
+$enddefinitions $end
+#0
+$dumpvars
+0!
+b101 "
+bx #
+$end
+#5
+1!
+#10
+bzx1 "
+b0 #
+)");
+    fs::remove(path);
+}
+
+TEST_CASE("Wave dump -- scope and level selection") {
+    auto path = getTempPath("slang_wave_scopes.vcd");
+    auto dump = [&](std::string_view scope, uint32_t levels) {
+        {
+            WaveDumper dumper(path.string(), WaveFormat::VCD);
+            dumper.addSignal("", "a", 1, false, WaveVarKind::Wire);
+            dumper.addSignal("top", "b", 1, false, WaveVarKind::Wire);
+            dumper.addSignal("top.x", "c", 1, false, WaveVarKind::Wire);
+            dumper.addSignal("top.x.y", "d", 1, false, WaveVarKind::Wire);
+            dumper.addSignal("topper", "e", 1, false, WaveVarKind::Wire);
+            dumper.selectScope(scope, levels);
+            dumper.setTime(0);
+        }
+
+        std::string names;
+        std::istringstream lines(readFile(path));
+        for (std::string line; std::getline(lines, line);) {
+            if (line.compare(0, 5, "$var ") == 0)
+                names += line.substr(line.size() - 6, 1);
+        }
+        return names;
+    };
+
+    CHECK(dump("top", 0) == "bcd");
+    CHECK(dump("top", 1) == "b");
+    CHECK(dump("top", 2) == "bc");
+    CHECK(dump("top.x", 0) == "cd");
+    CHECK(dump("", 1) == "a");
+    CHECK(dump("", 2) == "abe");
+    CHECK(dump("", 0) == "abcde");
+    CHECK(dump("nothing", 0).empty());
+    fs::remove(path);
+}
+
+TEST_CASE("Wave dump -- four-state storage layout") {
+    // A 70-bit four-state signal stores its unknown bits directly after the
+    // value bits, at bit 70, so it spans three storage words in total.
+    uint64_t storage[3] = {};
+    auto setBit = [&](uint32_t bit) { storage[bit / 64] |= 1ull << (bit % 64); };
+    setBit(0); // bit 0 = 1
+    setBit(70 + 1); // bit 1 = x
+    setBit(2); // bit 2 = z
+    setBit(70 + 2);
+    setBit(69); // bit 69 = 1
+    setBit(68); // bit 68 = z
+    setBit(70 + 68);
+
+    auto path = getTempPath("slang_wave_layout.vcd");
+    {
+        WaveDumper dumper(path.string(), WaveFormat::VCD);
+        auto id = dumper.addSignal("top", "wide", 70, true, WaveVarKind::Wire);
+        dumper.selectSignal(id);
+        dumper.setTime(0);
+        dumper.valueChanged(id, storage);
+    }
+
+    std::string expected = "b1z" + std::string(65, '0') + "zx1 !\n";
+    auto contents = readFile(path);
+    CHECK(contents.find("$dumpvars\n" + expected + "$end\n") != std::string::npos);
+
+    path = getTempPath("slang_wave_layout.bin");
+    {
+        WaveDumper dumper(path.string(), WaveFormat::ChangeLog);
+        auto id = dumper.addSignal("top", "wide", 70, true, WaveVarKind::Wire);
+        dumper.selectSignal(id);
+        dumper.setTime(3);
+        dumper.valueChanged(id, storage);
+    }
+
+    // Magic, version, one signal (width 70, four-state, name), then a single
+    // timestep with one change: value bytes followed by unknown bytes.
+    std::string header = std::string("SLWV\x01\x01\x46\x01\x08", 9) + "top.wide";
+    std::string step = std::string("\x03\x01\x00", 3);
+    std::string value = std::string("\x05\0\0\0\0\0\0\0\x30", 9);
+    std::string unknown = std::string("\x06\0\0\0\0\0\0\0\x10", 9);
+    CHECK(readFile(path) == header + step + value + unknown);
+    fs::remove(path);
+}
+
+static uint32_t openFile(const fs::path& path, std::string_view mode) {
+    std::string str = path.string();
+    return fileOpen(str.data(), str.size(), mode.data(), mode.size());
+}
+
+static void writeFile(uint32_t fd, std::string_view text) {
+    printStr(text.data(), text.size());
+    flushToFile(fd, false);
+}
+
+static void writeFile(const fs::path& path, std::string_view text) {
+    std::ofstream(path, std::ios::binary).write(text.data(), std::streamsize(text.size()));
+}
+
+TEST_CASE("File I/O -- descriptor table") {
+    auto path1 = getTempPath("slang_fileio_1.txt");
+    auto path2 = getTempPath("slang_fileio_2.txt");
+
+    auto fd1 = openFile(path1, "w");
+    auto fd2 = openFile(path2, "w");
+    CHECK((fd1 & FileTable::FdFlag));
+    CHECK((fd2 & FileTable::FdFlag));
+    CHECK(fd1 > FileTable::Stderr);
+    CHECK(fd1 != fd2);
+
+    // Closed descriptors are reused.
+    fileClose(fd1);
+    CHECK(fileGetc(fd1) == EOF);
+    CHECK(openFile(path1, "w") == fd1);
+    fileClose(fd1);
+    fileClose(fd2);
+
+    // Bad modes and missing files both fail and report why.
+    ScanString message;
+    CHECK(openFile(path1, "q") == 0);
+    CHECK(fileError(0, &message) == EINVAL);
+    CHECK(openFile(getTempPath("slang_no_such_dir") / "file.txt", "r") == 0);
+    CHECK(fileError(0, &message) == ENOENT);
+    CHECK(message.length > 0);
+    CHECK(fileError(0, &message) == 0);
+
+    // Opening without a mode gives a multichannel descriptor, with one bit per
+    // file. Bit zero is stdout and is never handed out.
+    auto mcd1 = openFile(path1, "");
+    auto mcd2 = openFile(path2, "");
+    CHECK(!(mcd1 & FileTable::FdFlag));
+    CHECK(!(mcd2 & FileTable::FdFlag));
+    CHECK((mcd1 & (mcd1 - 1)) == 0);
+    CHECK((mcd2 & (mcd2 - 1)) == 0);
+    CHECK(mcd1 != mcd2);
+    CHECK(mcd1 > 1);
+    CHECK(mcd2 > 1);
+    CHECK(!FileTable::includesStdout(mcd1 | mcd2));
+
+    writeFile(mcd1 | mcd2, "both\n");
+    writeFile(mcd2, "second\n");
+    fileClose(mcd1 | mcd2);
+
+    CHECK(readFile(path1) == "both\n");
+    CHECK(readFile(path2) == "both\nsecond\n");
+    fs::remove(path1);
+    fs::remove(path2);
+}
+
+TEST_CASE("File I/O -- $fgets") {
+    auto path = getTempPath("slang_fileio_gets.txt");
+    writeFile(path, "hello\nworld without newline");
+
+    auto fd = openFile(path, "r");
+    REQUIRE(fd);
+
+    // Characters are stored with the last one in the least significant byte.
+    uint64_t storage[2] = { 0, ~0ull };
+    CHECK(fileGets(fd, storage, 64, true) == 6);
+    CHECK(storage[0] == 0x68656c6c6f0a);
+    CHECK(storage[1] == 0);
+
+    // At most width / 8 characters are read.
+    CHECK(fileGets(fd, storage, 32, false) == 4);
+    CHECK(storage[0] == 0x776f726c);
+    CHECK(!fileEof(fd));
+
+    CHECK(fileGets(fd, storage, 128, false) == 16);
+    CHECK(storage[1] == 0x6420776974686f75);
+    CHECK(storage[0] == 0x74206e65776c696e);
+    CHECK(fileGets(fd, storage, 64, false) == 1);
+    CHECK(storage[0] == 'e');
+    CHECK(fileEof(fd));
+    CHECK(fileGets(fd, storage, 64, false) == 0);
+
+    fileClose(fd);
+    fs::remove(path);
+}
+
+TEST_CASE("File I/O -- $fscanf conversions") {
+    auto path = getTempPath("slang_fileio_scanf.txt");
+    writeFile(path, "42 -17 ff 1010 3.5 word x1z\n"
+                    "123456789012345678901234567890 abc");
+
+    auto fd = openFile(path, "r");
+    REQUIRE(fd);
+
+    uint64_t dec = 0, neg = 0, hex = 0, bin = 0, fourState = 0;
+    double real = 0;
+    ScanString str;
+    ScanArg args[] = { { &dec, 32, ScanArgKind::TwoState },
+                       { &neg, 32, ScanArgKind::TwoState },
+                       { &hex, 8, ScanArgKind::TwoState },
+                       { &bin, 4, ScanArgKind::TwoState },
+                       { &real, 64, ScanArgKind::Real },
+                       { &str, 0, ScanArgKind::String },
+                       { &fourState, 12, ScanArgKind::FourState } };
+
+    std::string_view format = "%d %d %h %b %f %s %h";
+    CHECK(fileScanf(fd, format.data(), format.size(), args, 7, "", 0) == 7);
+    CHECK(dec == 42);
+    CHECK(neg == 0xffffffef);
+    CHECK(hex == 0xff);
+    CHECK(bin == 0b1010);
+    CHECK(real == 3.5);
+    CHECK(std::string_view(str.data, str.length) == "word");
+
+    // x1z: value bits 0000'0001'1111 and unknown bits 1111'0000'1111 above them.
+    CHECK(fourState == (0x01f | (0xf0f << 12)));
+
+    // Values wider than 64 bits go through the arbitrary precision path.
+    uint64_t wide[2] = {};
+    ScanArg wideArg{ wide, 100, ScanArgKind::TwoState };
+    format = "%d";
+    CHECK(fileScanf(fd, format.data(), format.size(), &wideArg, 1, "", 0) == 1);
+
+    auto expected = "100'd123456789012345678901234567890"_si;
+    CHECK(wide[0] == expected.getRawPtr()[0]);
+    CHECK(wide[1] == expected.getRawPtr()[1]);
+
+    // A failed match consumes nothing, so the rest is still there to read as a string.
+    CHECK(fileScanf(fd, format.data(), format.size(), &wideArg, 1, "", 0) == 0);
+
+    format = "%s";
+    ScanArg strArg{ &str, 0, ScanArgKind::String };
+    CHECK(fileScanf(fd, format.data(), format.size(), &strArg, 1, "", 0) == 1);
+    CHECK(std::string_view(str.data, str.length) == "abc");
+    CHECK(fileScanf(fd, format.data(), format.size(), &strArg, 1, "", 0) == EOF);
+
+    fileClose(fd);
+    fs::remove(path);
+}
+
+TEST_CASE("File I/O -- $feof and %m") {
+    auto path = getTempPath("slang_fileio_eof.txt");
+
+    // A file being written is never at EOF, and checking doesn't disturb it.
+    auto fd = openFile(path, "w");
+    REQUIRE(fd);
+    writeFile(fd, "ab");
+    CHECK(!fileEof(fd));
+    writeFile(fd, "c");
+    fileClose(fd);
+    CHECK(readFile(path) == "abc");
+
+    // As with feof, the flag is only set once a read runs into the end.
+    fd = openFile(path, "r");
+    REQUIRE(fd);
+    CHECK(fileGetc(fd) == 'a');
+    CHECK(fileGetc(fd) == 'b');
+    CHECK(fileGetc(fd) == 'c');
+    CHECK(!fileEof(fd));
+    CHECK(fileGetc(fd) == EOF);
+    CHECK(fileEof(fd));
+    fileClose(fd);
+    fs::remove(path);
+
+    // %m produces the caller's scope and consumes no input.
+    ScanString scope, word;
+    ScanArg args[] = { { &scope, 0, ScanArgKind::String }, { &word, 0, ScanArgKind::String } };
+    std::string_view text = "word";
+    std::string_view format = "%m%s";
+    std::string_view name = "top.sub";
+    CHECK(stringScanf(text.data(), text.size(), format.data(), format.size(), args, 2,
+                      name.data(), name.size()) == 2);
+    CHECK(std::string_view(scope.data, scope.length) == "top.sub");
+    CHECK(std::string_view(word.data, word.length) == "word");
+}
+
+TEST_CASE("File I/O -- $fread") {
+    auto path = getTempPath("slang_fileio_read.bin");
+    writeFile(path, std::string("\x12\x34"
+                                "\x56\x78\x9a\xbc\xde\xf0\x11\x22\x33"
+                                "\x01\x02\x03\x04\x05\xa1\xa2\xa3\xa4\xa5\xff\xee",
+                                23));
+
+    auto fd = openFile(path, "rb");
+    REQUIRE(fd);
+
+    // Packed destinations are filled most significant byte first.
+    uint64_t storage[3] = { 0, 0, ~0ull };
+    CHECK(fileRead(fd, storage, 16, false) == 2);
+    CHECK(storage[0] == 0x1234);
+
+    CHECK(fileRead(fd, storage, 72, true) == 9);
+    CHECK(storage[0] == 0x789abcdef0112233);
+    CHECK(storage[1] == 0x56);
+    CHECK(storage[2] == 0);
+
+    // Unpacked elements each take a whole number of words; a 40-bit four-state
+    // element needs two. The trailing partial element is stored as-is.
+    uint64_t memory[6];
+    std::fill(std::begin(memory), std::end(memory), ~0ull);
+    CHECK(fileReadMemory(fd, memory, 40, true, 3) == 12);
+    CHECK(memory[0] == 0x0102030405);
+    CHECK(memory[1] == 0);
+    CHECK(memory[2] == 0xa1a2a3a4a5);
+    CHECK(memory[3] == 0);
+    CHECK(memory[4] == 0xffee);
+    CHECK(memory[5] == 0);
+
+    CHECK(fileEof(fd));
+    CHECK(fileRead(fd, storage, 16, false) == 0);
+
+    fileClose(fd);
+    fs::remove(path);
+}
+
+TEST_CASE("File I/O -- $fread short reads") {
+    auto path = getTempPath("slang_fileio_short.bin");
+
+    // Whatever the width, the bytes that were read end up at the bottom of the
+    // value and the missing high-order bytes are zero.
+    auto readShort = [&](uint32_t width, uint64_t* storage) {
+        writeFile(path, std::string("\x12\x34\x56", 3));
+        auto fd = openFile(path, "rb");
+        REQUIRE(fd);
+        CHECK(fileRead(fd, storage, width, true) == 3);
+        fileClose(fd);
+    };
+
+    uint64_t narrow[2] = { ~0ull, ~0ull };
+    readShort(40, narrow);
+    CHECK(narrow[0] == 0x123456);
+    CHECK(narrow[1] == 0);
+
+    uint64_t wide[4] = { ~0ull, ~0ull, ~0ull, ~0ull };
+    readShort(100, wide);
+    CHECK(wide[0] == 0x123456);
+    CHECK(wide[1] == 0);
+    CHECK(wide[2] == 0);
+    CHECK(wide[3] == 0);
+
+    fs::remove(path);
+}
+
+TEST_CASE("File I/O -- buffered seek and tell") {
+    auto path = getTempPath("slang_fileio_seek.txt");
+    auto fd = openFile(path, "w+");
+    REQUIRE(fd);
+
+    writeFile(fd, "0123456789");
+    CHECK(fileTell(fd) == 10);
+
+    CHECK(fileSeek(fd, 2, 0) == 0);
+    CHECK(fileTell(fd) == 2);
+    CHECK(fileGetc(fd) == '2');
+    CHECK(fileTell(fd) == 3);
+
+    CHECK(fileUngetc('X', fd) == 0);
+    CHECK(fileTell(fd) == 2);
+    CHECK(fileGetc(fd) == 'X');
+
+    CHECK(fileSeek(fd, 3, 1) == 0);
+    CHECK(fileTell(fd) == 6);
+    CHECK(fileGetc(fd) == '6');
+
+    // Switching from reading to writing happens at the logical position,
+    // not wherever read-ahead left the underlying file.
+    writeFile(fd, "ab");
+    CHECK(fileTell(fd) == 9);
+
+    CHECK(fileSeek(fd, 0, 2) == 0);
+    CHECK(fileTell(fd) == 10);
+    CHECK(fileSeek(fd, -100, 1) == EOF);
+
+    CHECK(fileRewind(fd) == 0);
+    uint64_t storage[2] = {};
+    CHECK(fileGets(fd, storage, 80, false) == 10);
+    CHECK(storage[1] == 0x3031);
+    CHECK(storage[0] == 0x3233343536616239);
+
+    fileClose(fd);
+
+    // Seek across buffer refills in a file larger than the file buffer.
+    std::string big(BufferedFile::BufferSize * 3, '\0');
+    for (size_t i = 0; i < big.size(); i++)
+        big[i] = char(i % 251);
+    writeFile(path, big);
+
+    fd = openFile(path, "rb");
+    REQUIRE(fd);
+
+    auto checkAt = [&](int64_t pos) {
+        CHECK(fileTell(fd) == pos);
+        CHECK(fileGetc(fd) == int(pos % 251));
+    };
+
+    std::vector<uint64_t> memory(BufferedFile::BufferSize + 5);
+    CHECK(fileReadMemory(fd, memory.data(), 8, false, memory.size()) == int64_t(memory.size()));
+    CHECK(memory.back() == (memory.size() - 1) % 251);
+    checkAt(int64_t(memory.size()));
+
+    int64_t pos = int64_t(BufferedFile::BufferSize * 5 / 2);
+    CHECK(fileSeek(fd, pos, 0) == 0);
+    checkAt(pos);
+
+    CHECK(fileSeek(fd, -int64_t(BufferedFile::BufferSize) - 1, 1) == 0);
+    checkAt(pos - int64_t(BufferedFile::BufferSize));
+
+    fileClose(fd);
+    fs::remove(path);
+}
+
+#if !defined(_WIN32)
+TEST_CASE("File I/O -- offsets past 4 GiB") {
+    // Sparse files make this cheap on the file systems we run tests on.
+    auto path = getTempPath("slang_fileio_large.bin");
+    writeFile(path, "");
+    const int64_t size = 5ll << 30;
+    fs::resize_file(path, uintmax_t(size));
+
+    auto fd = openFile(path, "r+b");
+    REQUIRE(fd);
+
+    const int64_t pos = (4ll << 30) + 7;
+    CHECK(fileSeek(fd, pos, 0) == 0);
+    CHECK(fileTell(fd) == pos);
+    writeFile(fd, "z");
+    CHECK(fileTell(fd) == pos + 1);
+
+    CHECK(fileSeek(fd, -1, 1) == 0);
+    CHECK(fileTell(fd) == pos);
+    CHECK(fileGetc(fd) == 'z');
+
+    CHECK(fileSeek(fd, 0, 2) == 0);
+    CHECK(fileTell(fd) == size);
+
+    fileClose(fd);
+    fs::remove(path);
+}
+#endif
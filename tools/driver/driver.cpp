@@ -14,6 +14,7 @@
 #include "slang/parsing/Preprocessor.h"
 #include "slang/symbols/ASTSerializer.h"
 #include "slang/symbols/CompilationUnitSymbols.h"
+#include "slang/symbols/DesignFingerprint.h"
 #include "slang/symbols/InstanceSymbols.h"
 #include "slang/syntax/SyntaxPrinter.h"
 #include "slang/syntax/SyntaxTree.h"
@@ -26,6 +27,7 @@
 
 #if defined(INCLUDE_SIM)
 #    include "slang/codegen/JIT.h"
+#    include "slang/mir/Interpreter.h"
 #    include "slang/mir/MIRBuilder.h"
 #endif
 
@@ -76,6 +78,7 @@ void printMacros(SourceManager& sourceManager, const Bag& options,
     BumpAllocator alloc;
     Diagnostics diagnostics;
     Preprocessor preprocessor(sourceManager, alloc, diagnostics, options);
+    preprocessor.setDirectivesOnly(true);
 
     for (auto it = buffers.rbegin(); it != buffers.rend(); it++)
         preprocessor.pushSource(*it);
@@ -101,6 +104,30 @@ void printMacros(SourceManager& sourceManager, const Bag& options,
     }
 }
 
+// Escapes a file name for use in a Makefile style dependency rule.
+std::string escapeDependency(string_view path) {
+    std::string result;
+    for (char c : path) {
+        if (c == ' ' || c == '#')
+            result += '\\';
+        else if (c == '$')
+            result += '$';
+        result += c;
+    }
+    return result;
+}
+
+void writeDepfile(const SourceManager& sourceManager, string_view fileName, string_view target) {
+    std::string result = escapeDependency(target);
+    result += ':';
+    for (auto& path : sourceManager.getLoadedFiles()) {
+        result += " \\\n  ";
+        result += escapeDependency(path);
+    }
+    result += '\n';
+    writeToFile(fileName, result);
+}
+
 bool runCompiler(Compilation& compilation, const std::vector<std::string>& warningOptions,
                  uint32_t errorLimit, bool quiet, bool onlyParse, bool showColors,
                  const optional<std::string>& astJsonFile,
@@ -185,10 +212,20 @@ bool runCompiler(Compilation& compilation, const std::vector<std::string>& warni
 #if defined(INCLUDE_SIM)
 using namespace slang::mir;
 
-bool runSim(Compilation& compilation) {
+bool runSim(Compilation& compilation, bool useJit) {
     MIRBuilder builder(compilation);
     builder.elaborate();
 
+    // Procedures lowered so far all come from initial blocks, which run exactly
+    // once; interpreting them is cheaper than paying for JIT startup, so the JIT
+    // is only used when asked for explicitly.
+    if (!useJit) {
+        Interpreter interpreter(builder);
+        for (auto& proc : builder.getInitialProcs())
+            interpreter.run(*proc);
+        return true;
+    }
+
     CodeGenerator codegen(compilation);
     codegen.emitAll(builder);
 
@@ -230,6 +267,7 @@ int driverMain(int argc, TArgs argv, bool suppressColors) try {
     optional<bool> includeComments;
     optional<bool> includeDirectives;
     optional<uint32_t> maxIncludeDepth;
+    optional<bool> prefetchIncludes;
     std::vector<std::string> defines;
     std::vector<std::string> undefines;
     cmdLine.add("-D,--define-macro", defines,
@@ -242,6 +280,8 @@ int driverMain(int argc, TArgs argv, bool suppressColors) try {
                 "Include compiler directives in preprocessed output (with -E)");
     cmdLine.add("--max-include-depth", maxIncludeDepth,
                 "Maximum depth of nested include files allowed", "<depth>");
+    cmdLine.add("--prefetch-includes", prefetchIncludes,
+                "Load included files on a background thread ahead of when they're needed");
 
     // Parsing
     optional<uint32_t> maxParseDepth;
@@ -265,6 +305,12 @@ int driverMain(int argc, TArgs argv, bool suppressColors) try {
                 "given hierarchical paths",
                 "<path>");
 
+    optional<std::string> fingerprintFile;
+    cmdLine.add("--fingerprint-json", fingerprintFile,
+                "Write structural hashes of the elaborated design hierarchy in JSON format "
+                "to the specified file, or '-' for stdout",
+                "<file>");
+
     // Compilation
     optional<uint32_t> maxInstanceDepth;
     optional<uint32_t> maxGenerateSteps;
@@ -290,6 +336,27 @@ int driverMain(int argc, TArgs argv, bool suppressColors) try {
                 "Maximum number of frames to show when printing a constant evaluation "
                 "backtrace; the rest will be abbreviated",
                 "<limit>");
+    optional<uint32_t> memoryLimit;
+    optional<uint32_t> timeLimit;
+    cmdLine.add("--memory-limit", memoryLimit,
+                "Maximum amount of memory, in megabytes, that elaboration can use "
+                "before it is stopped",
+                "<megabytes>");
+    cmdLine.add("--time-limit", timeLimit,
+                "Maximum amount of time, in milliseconds, that elaboration can take "
+                "before it is stopped",
+                "<milliseconds>");
+    optional<bool> foldConstants;
+    cmdLine.add("--fold-constants", foldConstants,
+                "Fold constant subexpressions into literals as expressions are bound");
+    optional<bool> hierarchyOnly;
+    cmdLine.add("--hierarchy-only", hierarchyOnly,
+                "Only elaborate the design hierarchy and port connections; procedural code, "
+                "subroutine bodies, and other expressions are not checked");
+    optional<bool> compactGates;
+    cmdLine.add("--compact-gates", compactGates,
+                "Store simple gate primitive instances in a compact table instead of "
+                "creating a symbol for each one (useful for large gate-level netlists)");
     cmdLine.add("-T,--timing", minTypMax,
                 "Select which value to consider in min:typ:max expressions", "min|typ|max");
     cmdLine.add("--top", topModules,
@@ -319,12 +386,32 @@ int driverMain(int argc, TArgs argv, bool suppressColors) try {
     optional<bool> singleUnit;
     std::vector<std::string> sourceFiles;
     cmdLine.add("--single-unit", singleUnit, "Treat all input files as a single compilation unit");
+    optional<uint32_t> numThreads;
+    cmdLine.add("--threads", numThreads,
+                "Number of threads to use when parsing with --single-unit; "
+                "the default picks based on the number of cores, and 1 parses serially",
+                "<count>");
     cmdLine.setPositional(sourceFiles, "files");
 
+    // Dependency output
+    optional<std::string> depfile;
+    optional<std::string> depfileTarget;
+    cmdLine.add("-M,--depfile", depfile,
+                "Write a Makefile / Ninja compatible dependency file listing every file read",
+                "<file>");
+    cmdLine.add("--depfile-target", depfileTarget,
+                "Target name to use in the dependency file (defaults to the depfile itself)",
+                "<name>");
+
 #if defined(INCLUDE_SIM)
     // Simulation
     optional<bool> shouldSim;
+    optional<std::string> simMode;
     cmdLine.add("--sim", shouldSim, "After compiling, try to simulate the design");
+    cmdLine.add("--sim-mode", simMode,
+                "How to execute the design: interpret it directly (the default) "
+                "or compile it with the JIT first",
+                "interp|jit");
 #endif
 
     if (!cmdLine.parse(argc, argv)) {
@@ -383,6 +470,8 @@ int driverMain(int argc, TArgs argv, bool suppressColors) try {
     ppoptions.predefineSource = "<command-line>";
     if (maxIncludeDepth.has_value())
         ppoptions.maxIncludeDepth = *maxIncludeDepth;
+    if (prefetchIncludes == true)
+        ppoptions.prefetchIncludes = true;
 
     LexerOptions loptions;
     if (maxLexerErrors.has_value())
@@ -404,6 +493,16 @@ int driverMain(int argc, TArgs argv, bool suppressColors) try {
         coptions.maxConstexprSteps = *maxConstexprSteps;
     if (maxConstexprBacktrace.has_value())
         coptions.maxConstexprBacktrace = *maxConstexprBacktrace;
+    if (memoryLimit.has_value())
+        coptions.memoryLimit = uint64_t(*memoryLimit) * 1024 * 1024;
+    if (timeLimit.has_value())
+        coptions.timeLimit = *timeLimit;
+    if (foldConstants == true)
+        coptions.foldConstants = true;
+    if (compactGates == true)
+        coptions.compactGates = true;
+    if (hierarchyOnly == true)
+        coptions.hierarchyOnly = true;
     if (errorLimit.has_value())
         coptions.errorLimit = *errorLimit * 2;
 
@@ -426,6 +525,14 @@ int driverMain(int argc, TArgs argv, bool suppressColors) try {
         }
     }
 
+#if defined(INCLUDE_SIM)
+    if (simMode.has_value() && simMode != "interp" && simMode != "jit") {
+        OS::print(fg(errorColor), "error: ");
+        OS::print("invalid value for sim mode option: '{}'", *simMode);
+        return 1;
+    }
+#endif
+
     Bag options;
     options.set(ppoptions);
     options.set(loptions);
@@ -471,7 +578,8 @@ int driverMain(int argc, TArgs argv, bool suppressColors) try {
         else {
             Compilation compilation(options);
             if (singleUnit == true) {
-                compilation.addSyntaxTree(SyntaxTree::fromBuffers(buffers, sourceManager, options));
+                compilation.addSyntaxTree(SyntaxTree::fromBuffersParallel(
+                    buffers, sourceManager, options, numThreads.value_or(0)));
             }
             else {
                 for (const SourceBuffer& buffer : buffers)
@@ -483,12 +591,26 @@ int driverMain(int argc, TArgs argv, bool suppressColors) try {
                 !runCompiler(compilation, warningOptions, errorLimit.value_or(20), quiet == true,
                              onlyParse == true, showColors, astJsonFile, astJsonScopes);
 
+            if (fingerprintFile && onlyParse != true) {
+                JsonWriter writer;
+                writer.setPrettyPrint(true);
+                DesignFingerprint(compilation).serialize(writer);
+                writeToFile(*fingerprintFile, writer.view());
+            }
+
 #if defined(INCLUDE_SIM)
             if (!anyErrors && !onlyParse.value_or(false) && shouldSim == true) {
-                anyErrors = !runSim(compilation);
+                anyErrors = !runSim(compilation, simMode == "jit");
             }
 #endif
         }
+
+        if (depfile) {
+            // Let any outstanding include prefetches settle so they can't race
+            // with building the list of files that were actually used.
+            sourceManager.waitForPrefetch();
+            writeDepfile(sourceManager, *depfile, depfileTarget.value_or(*depfile));
+        }
     }
     catch (const std::exception& e) {
 #ifdef FUZZ_TARGET
@@ -517,7 +639,7 @@ void writeToFile(Stream& os, string_view fileName, String contents) {
     os.write(contents.data(), contents.size());
     os.flush();
     if (!os)
-        throw std::runtime_error(fmt::format("Unable to write AST to '{}'", fileName));
+        throw std::runtime_error(fmt::format("Unable to write to '{}'", fileName));
 }
 
 #if defined(_MSC_VER)